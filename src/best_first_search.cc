@@ -0,0 +1,622 @@
+/**
+ * @file best_first_search.cc
+ *
+ * Best-first search of states ordered by a heuristic priority.
+ */
+
+#include "best_first_search.hh"
+#include "engine_pool.hh"
+#include "term_tables.hh"
+#include "trace_recorder.hh"
+
+#include "dagNode.hh"
+#include "rule.hh"
+#include "visibleModule.hh"
+#include "importModule.hh"
+#include "rewriteSearchState.hh"
+#include "matchSearchState.hh"
+#include "pattern.hh"
+
+// for the numeric values of the heuristic
+#include "NA_Theory.hh"
+#include "floatDagNode.hh"
+#include "succSymbol.hh"
+#include "minusSymbol.hh"
+#include "SMT_NumberDagNode.hh"
+#include "S_Theory.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+/**
+ * Table of the states of a best-first search.
+ */
+class BestFirstStateTable : public TermTable {
+public:
+	BestFirstStateTable(VisibleModule* vmod) : TermTable(vmod) {}
+
+	using TermTable::insert;
+	using TermTable::lookup;
+	using TermTable::clear;
+
+	DagNode* getDag(int position) const { return nodes[position]; }
+};
+
+namespace {
+
+/**
+ * Flush the contents of a file to the disk.
+ */
+bool
+syncFile(const string &path) {
+#ifdef _WIN32
+	(void) path;
+	return true;
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+
+	if (fd < 0)
+		return false;
+
+	bool synced = fsync(fd) == 0;
+	return close(fd) == 0 && synced;
+#endif
+}
+
+/**
+ * Get the value of a reduced float, integer or SMT number.
+ *
+ * @param natSymbol Successor symbol of the module to recognize zero
+ * (which is an ordinary constant) or null.
+ *
+ * @return Whether the term is a number.
+ */
+bool
+getNumber(DagNode* dag, SuccSymbol* natSymbol, double &value) {
+	if (auto fdag = dynamic_cast<FloatDagNode*>(dag))
+		value = fdag->getValue();
+	else if (auto ndag = dynamic_cast<SMT_NumberDagNode*>(dag))
+		value = ndag->getValue().get_d();
+	else if (auto succ = dynamic_cast<SuccSymbol*>(dag->symbol()); succ != nullptr && succ->isNat(dag))
+		value = succ->getNat(dag).get_d();
+	else if (auto minus = dynamic_cast<MinusSymbol*>(dag->symbol()); minus != nullptr && minus->isNeg(dag)) {
+		mpz_class result;
+		value = minus->getNeg(dag, result).get_d();
+	}
+	else if (natSymbol != nullptr && natSymbol->isNat(dag))
+		value = 0.0;
+	else
+		return false;
+
+	return true;
+}
+
+}
+
+BestFirstSearch::BestFirstSearch(EasyTerm* initial, SearchType type, EasyTerm* target,
+                                 const Vector<ConditionFragment*> &condition, int depth)
+ : vmod(safeCast(VisibleModule*, initial->symbol()->getModule())),
+   context(new RecordingRewritingContext(initial->getDag())),
+   type(type),
+   maxDepth(depth),
+   table(make_unique<BestFirstStateTable>(vmod))
+{
+	if (type == BRANCH) {
+		IssueWarning("branching search is not supported in best-first search.");
+		valid = false;
+		return;
+	}
+
+	if (target->symbol()->getModule() != vmod) {
+		IssueWarning("the pattern does not belong to the module of the initial term.");
+		valid = false;
+		return;
+	}
+
+	// Patterns take ownership of the condition, so we need to pass them a copy
+	Vector<ConditionFragment*> conditionCopy;
+	ImportModule::deepCopyCondition(nullptr, condition, conditionCopy);
+
+	goal = new Pattern(target->termCopy(), false, conditionCopy);
+	targetTerm = target->serialize();
+}
+
+BestFirstSearch::~BestFirstSearch() {
+	delete match;
+	delete goal;
+	delete context;
+}
+
+bool
+BestFirstSearch::setHeuristic(Symbol* symbol, bool astar) {
+	if (started) {
+		IssueWarning("the heuristic cannot be changed once the search has started.");
+		return false;
+	}
+
+	if (symbol->getModule() != vmod || symbol->arity() != 1) {
+		IssueWarning("the heuristic must be a unary operator of the module of the search.");
+		return false;
+	}
+
+	heuristicSymbol = symbol;
+	heuristic = nullptr;
+	depthWeight = astar ? 1.0 : 0.0;
+
+	const Vector<Symbol*> &symbols = vmod->getSymbols();
+
+	for (int i = 0; i < symbols.length() && natSymbol == nullptr; i++)
+		natSymbol = dynamic_cast<SuccSymbol*>(symbols[i]);
+
+	return true;
+}
+
+bool
+BestFirstSearch::setHeuristic(SearchHeuristic* heuristic, bool astar) {
+	if (started) {
+		IssueWarning("the heuristic cannot be changed once the search has started.");
+		return false;
+	}
+
+	heuristicSymbol = nullptr;
+	this->heuristic = heuristic;
+	depthWeight = astar ? 1.0 : 0.0;
+	return true;
+}
+
+void
+BestFirstSearch::setBeamWidth(int width) {
+	beamWidth = width;
+}
+
+void
+BestFirstSearch::setMaxStates(long long maxStates) {
+	this->maxStates = maxStates;
+}
+
+int
+BestFirstSearch::getNrStates() const {
+	return table->size();
+}
+
+DagNode*
+BestFirstSearch::getStateDag(int stateNr) const {
+	return table->getDag(stateNr);
+}
+
+EasySubstitution*
+BestFirstSearch::getSubstitution() const {
+	return match == nullptr ? nullptr : new EasySubstitution(match->getContext(), goal,
+	                                                         match->getExtensionInfo());
+}
+
+double
+BestFirstSearch::evaluate(DagNode* dag, int depth) {
+	double value = 0.0;
+
+	// The search has already been stopped by a wrong value
+	if (!valid)
+		return value;
+
+	if (heuristicSymbol != nullptr) {
+		Vector<DagNode*> args(1);
+		args[0] = dag;
+
+		RewritingContext* subcontext = context->makeSubcontext(heuristicSymbol->makeDagNode(args));
+		subcontext->reduce();
+		context->addInCount(*subcontext);
+
+		bool isNumber = getNumber(subcontext->root(), natSymbol, value);
+		delete subcontext;
+
+		if (!isNumber) {
+			IssueWarning("the heuristic operator " << QUOTE(heuristicSymbol)
+				<< " does not reduce to a number, so the search is stopped.");
+			valid = false;
+			return 0.0;
+		}
+	}
+	else if (heuristic != nullptr) {
+		EasyTerm state(dag);
+		value = heuristic->evaluate(&state);
+
+		// NaN breaks the order of the frontier
+		if (std::isnan(value)) {
+			IssueWarning("the heuristic returned NaN, so the search is stopped.");
+			valid = false;
+			return 0.0;
+		}
+	}
+	// Without heuristic, the exploration is breadth-first
+	else
+		return depth;
+
+	return value + depthWeight * depth;
+}
+
+void
+BestFirstSearch::addState(DagNode* dag, int parent, Rule* rule) {
+	int depth = parent < 0 ? 0 : depths[parent] + 1;
+	int index = table->lookup(dag);
+
+	if (index >= 0) {
+		bool shorter = depth < depths[index];
+
+		if (!shorter && !dropped[index]) {
+			nrDuplicates++;
+			return;
+		}
+
+		// A shorter path updates the state and moves it in the frontier
+		// (reopening it if it was already expanded), and the states
+		// dropped by the beam are readmitted when found again
+		if (shorter) {
+			frontier.erase({priorities[index], index});
+
+			// The heuristic value does not depend on the path
+			priorities[index] = heuristicSymbol == nullptr && heuristic == nullptr
+				? depth : priorities[index] + depthWeight * (depth - depths[index]);
+			parents[index] = parent;
+			rules[index] = rule;
+			depths[index] = depth;
+		}
+
+		dropped[index] = false;
+		enqueue(index);
+		return;
+	}
+
+	if (maxStates > 0 && table->size() >= maxStates) {
+		nrDropped++;
+		return;
+	}
+
+	index = table->insert(dag).first;
+	maxDepthReached = max(maxDepthReached, depth);
+
+	parents.push_back(parent);
+	rules.push_back(rule);
+	depths.push_back(depth);
+	priorities.push_back(evaluate(dag, depth));
+	dropped.push_back(false);
+	checked.push_back(false);
+
+	enqueue(index);
+}
+
+void
+BestFirstSearch::enqueue(int index) {
+	frontier.emplace(priorities[index], index);
+
+	// The worst states are dropped when the beam is full
+	if (beamWidth > 0 && frontier.size() > size_t(beamWidth)) {
+		auto worst = prev(frontier.end());
+		dropped[worst->second] = true;
+		frontier.erase(worst);
+		nrDropped++;
+	}
+}
+
+void
+BestFirstSearch::start() {
+	started = true;
+
+	context->reduce();
+	addState(context->root(), -1, nullptr);
+}
+
+int
+BestFirstSearch::expand(int stateNr, bool forward) {
+	RewritingContext* stateContext = context->makeSubcontext(table->getDag(stateNr));
+	RewriteSearchState state(stateContext, UNDEFINED,
+	                         RewriteSearchState::GC_CONTEXT | PositionState::RESPECT_FROZEN,
+	                         0, UNBOUNDED);
+	int nrSuccessors = 0;
+
+	while (state.findNextRewrite()) {
+		nrSuccessors++;
+
+		if (!forward)
+			break;
+
+		Rule* rule = state.getRule();
+		DagNode* replacement = state.rebuildDag(state.getReplacement()).first;
+		stateContext->incrementRlCount();
+
+		RewritingContext* subcontext = stateContext->makeSubcontext(replacement);
+		subcontext->reduce();
+		stateContext->addInCount(*subcontext);
+
+		addState(subcontext->root(), stateNr, rule);
+		delete subcontext;
+
+		if (UserLevelRewritingContext::aborted())
+			break;
+	}
+
+	context->addInCount(*stateContext);
+	return nrSuccessors;
+}
+
+EasyTerm*
+BestFirstSearch::next() {
+	if (!valid)
+		return nullptr;
+
+	// Other matches of the current solution state
+	if (match != nullptr) {
+		if (match->findNextMatch()) {
+			nrMatches++;
+			return new EasyTerm(table->getDag(stateNr));
+		}
+
+		delete match;
+		match = nullptr;
+	}
+
+	if (!started)
+		start();
+
+	while (valid && !frontier.empty() && !UserLevelRewritingContext::aborted()) {
+		int current = frontier.begin()->second;
+		frontier.erase(frontier.begin());
+
+		int depth = depths[current];
+
+		// Whether the successors of the state are explored
+		bool forward = (maxDepth < 0 || depth < maxDepth)
+			&& (type != ONE_STEP || depth == 0);
+		bool solutionDepth = type == ANY_STEPS
+			|| (type == AT_LEAST_ONE_STEP && depth > 0)
+			|| (type == ONE_STEP && depth == 1);
+
+		int nrSuccessors = 0;
+
+		// Normal forms are checked even beyond the depth bound
+		if (forward || type == NORMAL_FORM)
+			nrSuccessors = expand(current, forward);
+
+		// Reopened states are not reported as solutions again
+		if (!checked[current] && (solutionDepth || (type == NORMAL_FORM && nrSuccessors == 0))) {
+			checked[current] = true;
+			match = new MatchSearchState(context->makeSubcontext(table->getDag(current)),
+			                             goal, MatchSearchState::GC_CONTEXT);
+
+			if (match->findNextMatch()) {
+				context->addInCount(*match->getContext());
+				stateNr = current;
+				nrMatches = 1;
+				return new EasyTerm(table->getDag(current));
+			}
+
+			delete match;
+			match = nullptr;
+		}
+	}
+
+	stateNr = -1;
+	return nullptr;
+}
+
+//
+// Checkpoints
+//
+
+namespace {
+
+const char CHECKPOINT_MAGIC[] = "maude-bfs-checkpoint";
+const int CHECKPOINT_VERSION = 1;
+
+}
+
+bool
+BestFirstSearch::checkpoint(const string &path) const {
+	if (!valid)
+		return false;
+
+	PoolMessage data;
+	data.putString(CHECKPOINT_MAGIC);
+	data.putInt(CHECKPOINT_VERSION);
+	data.putString(targetTerm);
+	data.putInt(type);
+	data.putInt(maxDepth);
+	data.putInt(started);
+
+	int nrStates = table->size();
+	data.putInt(nrStates);
+
+	for (int i = 0; i < nrStates; i++) {
+		EasyTerm state(table->getDag(i));
+		data.putString(state.serialize());
+		data.putInt(parents[i]);
+		data.putInt(rules[i] == nullptr ? -1 : rules[i]->getIndexWithinModule());
+		data.putInt(depths[i]);
+		data.putDouble(priorities[i]);
+		data.putInt(dropped[i]);
+		data.putInt(checked[i]);
+	}
+
+	// Priorities in the frontier are those of the states
+	data.putInt(frontier.size());
+
+	for (const auto &entry : frontier)
+		data.putInt(entry.second);
+
+	data.putInt(match != nullptr ? stateNr : -1);
+	data.putInt(nrMatches);
+
+	data.putInt(maxDepthReached);
+	data.putInt(nrDuplicates);
+	data.putInt(nrDropped);
+
+	data.putInt(context->getMbCount());
+	data.putInt(context->getEqCount());
+	data.putInt(context->getRlCount());
+	data.putInt(context->getNarrowingCount());
+	data.putInt(context->getVariantNarrowingCount());
+
+	// The data is written to a temporary file first, so that an
+	// interruption does not destroy the previous checkpoint
+	string temporary = path + ".tmp";
+	{
+		ofstream file(temporary, ios::binary | ios::trunc);
+		file.write(data.data().data(), data.data().size());
+		file.close();
+
+		// The file must be on the disk before it replaces the previous one
+		if (file.fail() || !syncFile(temporary)) {
+			IssueWarning("cannot write checkpoint file " << QUOTE(temporary) << ".");
+			remove(temporary.c_str());
+			return false;
+		}
+	}
+
+	if (rename(temporary.c_str(), path.c_str()) != 0) {
+		IssueWarning("cannot write checkpoint file " << QUOTE(path) << ".");
+		remove(temporary.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+void
+BestFirstSearch::reset() {
+	table->clear();
+	parents.clear();
+	rules.clear();
+	depths.clear();
+	priorities.clear();
+	dropped.clear();
+	checked.clear();
+	frontier.clear();
+	maxDepthReached = 0;
+	nrDuplicates = 0;
+	nrDropped = 0;
+}
+
+bool
+BestFirstSearch::restore(const string &path) {
+	if (!valid)
+		return false;
+
+	if (started) {
+		IssueWarning("the search cannot be restored once it has started.");
+		return false;
+	}
+
+	ifstream file(path, ios::binary);
+
+	if (!file) {
+		IssueWarning("cannot open checkpoint file " << QUOTE(path) << ".");
+		return false;
+	}
+
+	string content((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+	PoolMessage data(std::move(content));
+
+	if (data.getString() != CHECKPOINT_MAGIC || data.getInt() != CHECKPOINT_VERSION) {
+		IssueWarning(QUOTE(path) << " is not a checkpoint of a best-first search.");
+		return false;
+	}
+
+	if (data.getString() != targetTerm || data.getInt() != type || data.getInt() != maxDepth) {
+		IssueWarning("the checkpoint " << QUOTE(path) << " belongs to a different search.");
+		return false;
+	}
+
+	// Nothing was explored when the checkpoint was taken
+	if (!data.getInt())
+		return true;
+
+	const Vector<Rule*> &moduleRules = vmod->getRules();
+	long long nrStates = data.getInt();
+	bool consistent = nrStates > 0;
+
+	for (long long i = 0; i < nrStates && consistent; i++) {
+		unique_ptr<EasyTerm> state(EasyTerm::deserialize(vmod, data.getString()));
+		int parent = data.getInt();
+		int rule = data.getInt();
+
+		if (state == nullptr || !table->insert(state->getDag()).second
+		    || parent < -1 || parent >= i || rule < -1 || rule >= moduleRules.length()) {
+			consistent = false;
+			break;
+		}
+
+		parents.push_back(parent);
+		rules.push_back(rule < 0 ? nullptr : moduleRules[rule]);
+		depths.push_back(data.getInt());
+		priorities.push_back(data.getDouble());
+		dropped.push_back(data.getInt() != 0);
+		checked.push_back(data.getInt() != 0);
+	}
+
+	// The initial state must be that of this search
+	if (consistent) {
+		RewritingContext* initial = context->makeSubcontext(context->root());
+		initial->reduce();
+		consistent = initial->root()->equal(table->getDag(0));
+		delete initial;
+	}
+
+	long long frontierSize = consistent ? data.getInt() : 0;
+
+	for (long long i = 0; i < frontierSize; i++) {
+		long long index = data.getInt();
+
+		if (index < 0 || index >= nrStates) {
+			consistent = false;
+			break;
+		}
+
+		frontier.emplace(priorities[index], index);
+	}
+
+	int solutionState = data.getInt();
+	int solutionMatches = data.getInt();
+
+	maxDepthReached = data.getInt();
+	nrDuplicates = data.getInt();
+	nrDropped = data.getInt();
+
+	Int64 counts[5];
+
+	for (Int64 &count : counts)
+		count = data.getInt();
+
+	if (!consistent || !data.atEnd() || solutionState < -1 || solutionState >= nrStates) {
+		IssueWarning("the checkpoint " << QUOTE(path) << " is corrupt or belongs to a different search.");
+		reset();
+		return false;
+	}
+
+	context->incrementMbCount(counts[0]);
+	context->incrementEqCount(counts[1]);
+	context->incrementRlCount(counts[2]);
+	context->incrementNarrowingCount(counts[3]);
+	context->incrementVariantNarrowingCount(counts[4]);
+
+	started = true;
+
+	// The match of the current solution is advanced to where it was
+	if (solutionState >= 0) {
+		stateNr = solutionState;
+		match = new MatchSearchState(context->makeSubcontext(table->getDag(stateNr)),
+		                             goal, MatchSearchState::GC_CONTEXT);
+
+		for (nrMatches = 0; nrMatches < solutionMatches && match->findNextMatch(); nrMatches++);
+	}
+
+	return true;
+}
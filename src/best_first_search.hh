@@ -0,0 +1,296 @@
+/**
+ * @file best_first_search.hh
+ *
+ * Best-first search of states ordered by a heuristic priority.
+ */
+
+#ifndef BEST_FIRST_SEARCH_HH
+#define BEST_FIRST_SEARCH_HH
+
+#include "easyTerm.hh"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+class BestFirstStateTable;
+class SuccSymbol;
+
+/**
+ * Heuristic function defined in the external language.
+ */
+struct SearchHeuristic {
+	/**
+	 * Method called to evaluate a state.
+	 *
+	 * @param state The state term (only valid during the call).
+	 *
+	 * @return The estimated distance to a solution (lower is better,
+	 * while NaN stops the search with a warning).
+	 */
+	virtual double evaluate(EasyTerm* state) = 0;
+	virtual ~SearchHeuristic() {};
+};
+
+/**
+ * Search that explores the state with the lowest priority first,
+ * where the priority is given by a heuristic function plus, optionally,
+ * the depth of the state (as in the A* algorithm). Without heuristic,
+ * states are explored in breadth-first order.
+ *
+ * States reached again by a shorter path are updated and explored again,
+ * so A* search finds optimal paths with admissible heuristics.
+ *
+ * The size of the frontier can be bounded (beam search), dropping the
+ * states with the highest priorities, which are readmitted if found
+ * again, and so can the number of stored states. Solutions may be missed
+ * when any of these limits is reached.
+ */
+class BestFirstSearch {
+public:
+	/**
+	 * Create a best-first search.
+	 *
+	 * @param initial Initial term (it is not modified).
+	 * @param type Type of search (@c BRANCH is not supported).
+	 * @param target Pattern term.
+	 * @param condition Condition that solutions must satisfy.
+	 * @param depth Depth bound (@c -1 for no bound).
+	 */
+	BestFirstSearch(EasyTerm* initial, SearchType type, EasyTerm* target,
+	                const Vector<ConditionFragment*> &condition = EasyTerm::NO_CONDITION,
+	                int depth = -1);
+	~BestFirstSearch();
+
+	/**
+	 * Set the heuristic as a unary operator of the module, which is
+	 * reduced on every state to a number (before the search starts).
+	 * Floats, integers and SMT numbers are accepted, and the search
+	 * stops with a warning on any other value.
+	 *
+	 * @param symbol Heuristic operator.
+	 * @param astar Whether the depth is added to the heuristic value.
+	 *
+	 * @return Whether the heuristic has been set.
+	 */
+	bool setHeuristic(Symbol* symbol, bool astar = false);
+
+	/**
+	 * Set the heuristic as an external function (before the search starts).
+	 *
+	 * @param heuristic Heuristic object (that must outlive the search).
+	 * @param astar Whether the depth is added to the heuristic value.
+	 *
+	 * @return Whether the heuristic has been set.
+	 */
+	bool setHeuristic(SearchHeuristic* heuristic, bool astar = false);
+
+	/**
+	 * Bound the number of states in the frontier (non-positive for no bound).
+	 */
+	void setBeamWidth(int width);
+
+	/**
+	 * Bound the number of stored states (non-positive for no bound).
+	 */
+	void setMaxStates(long long maxStates);
+
+	/**
+	 * Get the next solution.
+	 *
+	 * @return That solution or null if the end has been reached.
+	 */
+	EasyTerm* next();
+
+	/**
+	 * Get the matching substitution of the current solution.
+	 */
+	EasySubstitution* getSubstitution() const;
+
+	/**
+	 * Get the number of the state of the current solution (or @c -1).
+	 */
+	int getStateNr() const;
+
+	/**
+	 * Get the number of stored states.
+	 */
+	int getNrStates() const;
+
+	/**
+	 * Get the parent of a state (@c -1 for the initial one).
+	 */
+	int getStateParent(int stateNr) const;
+
+	/**
+	 * Get the rule leading to a state (null for the initial one).
+	 */
+	Rule* getStateRule(int stateNr) const;
+
+	/**
+	 * Get the DAG of a state.
+	 */
+	DagNode* getStateDag(int stateNr) const;
+
+	/**
+	 * Get the depth of a state.
+	 */
+	int getStateDepth(int stateNr) const;
+
+	/**
+	 * Get the depth of the deepest state stored.
+	 */
+	int getMaxDepthReached() const;
+
+	/**
+	 * Get the priority of a state.
+	 */
+	double getStatePriority(int stateNr) const;
+
+	/**
+	 * Get the number of states pending exploration.
+	 */
+	long long getFrontierSize() const;
+
+	/**
+	 * Get the number of successors that had already been visited.
+	 */
+	long long getNrDuplicates() const;
+
+	/**
+	 * Get the number of states dropped by the beam width or the
+	 * bound on the number of stored states.
+	 */
+	long long getNrDropped() const;
+
+	/**
+	 * Get the rewriting context of the search (with the rewrite counts).
+	 */
+	RewritingContext* getContext() const;
+
+	/**
+	 * Save the state of the search to a file, including the stored
+	 * states with their parents, rules, depths and priorities, the
+	 * frontier, the current solution and the counters.
+	 *
+	 * @param path Path of the file (replaced atomically).
+	 *
+	 * @return Whether the checkpoint has been written.
+	 */
+	bool checkpoint(const std::string &path) const;
+
+	/**
+	 * Resume the search from a checkpoint (before it starts).
+	 *
+	 * The search must have been created with the same initial term,
+	 * pattern, condition, and options as the saved one, possibly in
+	 * another process after loading the same modules.
+	 *
+	 * @param path Path of the file.
+	 *
+	 * @return Whether the search has been restored.
+	 */
+	bool restore(const std::string &path);
+
+private:
+	void start();
+	void reset();
+	int expand(int stateNr, bool forward);
+	void addState(DagNode* dag, int parent, Rule* rule);
+	void enqueue(int index);
+	double evaluate(DagNode* dag, int depth);
+
+	VisibleModule* vmod;
+	RewritingContext* context;
+	Pattern* goal = nullptr;
+	SearchType type;
+	int maxDepth;
+	// Serialized pattern to identify checkpoints
+	std::string targetTerm;
+
+	Symbol* heuristicSymbol = nullptr;
+	// Successor symbol of the module to recognize zero heuristic values
+	SuccSymbol* natSymbol = nullptr;
+	SearchHeuristic* heuristic = nullptr;
+	double depthWeight = 0.0;
+	int beamWidth = 0;
+	long long maxStates = 0;
+
+	std::unique_ptr<BestFirstStateTable> table;
+	std::vector<int> parents;
+	std::vector<Rule*> rules;
+	std::vector<int> depths;
+	std::vector<double> priorities;
+	// Whether each state has been dropped from the frontier by the beam
+	std::vector<bool> dropped;
+	// Whether each state has been matched against the pattern
+	std::vector<bool> checked;
+
+	// Pending states ordered by priority (and by number for ties)
+	std::set<std::pair<double, int>> frontier;
+
+	// Current solution and its match
+	int stateNr = -1;
+	MatchSearchState* match = nullptr;
+	int nrMatches = 0;
+
+	int maxDepthReached = 0;
+	long long nrDuplicates = 0;
+	long long nrDropped = 0;
+	bool started = false;
+	bool valid = true;
+};
+
+inline int
+BestFirstSearch::getStateNr() const {
+	return stateNr;
+}
+
+inline int
+BestFirstSearch::getStateParent(int stateNr) const {
+	return parents[stateNr];
+}
+
+inline Rule*
+BestFirstSearch::getStateRule(int stateNr) const {
+	return rules[stateNr];
+}
+
+inline int
+BestFirstSearch::getStateDepth(int stateNr) const {
+	return depths[stateNr];
+}
+
+inline int
+BestFirstSearch::getMaxDepthReached() const {
+	return maxDepthReached;
+}
+
+inline double
+BestFirstSearch::getStatePriority(int stateNr) const {
+	return priorities[stateNr];
+}
+
+inline long long
+BestFirstSearch::getFrontierSize() const {
+	return frontier.size();
+}
+
+inline long long
+BestFirstSearch::getNrDuplicates() const {
+	return nrDuplicates;
+}
+
+inline long long
+BestFirstSearch::getNrDropped() const {
+	return nrDropped;
+}
+
+inline RewritingContext*
+BestFirstSearch::getContext() const {
+	return context;
+}
+
+#endif // BEST_FIRST_SEARCH_HH
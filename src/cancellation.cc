@@ -0,0 +1,144 @@
+/**
+ * @file cancellation.cc
+ *
+ * Deadlines and cooperative cancellation of Maude operations.
+ */
+
+#include "cancellation.hh"
+#include "trace_recorder.hh"
+#include "search_monitor.hh"
+#include "maude_wrappers.hh"
+
+#include "macros.hh"
+#include "vector.hh"
+#include "core.hh"
+#include "interface.hh"
+#include "mixfix.hh"
+#include "higher.hh"
+#include "strategyLanguage.hh"
+#include "userLevelRewritingContext.hh"
+#include "interpreter.hh"
+#include "global.hh"
+
+using namespace std;
+
+//
+// Hack to abort the current calculation without necessarily terminating
+// the program and without entering in an unusable debugger. This implies
+// setting the abortFlag of UserLevelRewritingContext, which is a private
+// static attribute. The correct way would be subclassing
+// UserLevelRewritingContext and redefining its virtual methods.
+//
+
+bool* getMaudeAbortFlag();
+
+template<bool* N>
+struct AbortFlagHack {
+	friend bool* getMaudeAbortFlag() {
+		return N;
+	}
+};
+
+template struct AbortFlagHack<&UserLevelRewritingContext::abortFlag>;
+
+void
+setMaudeAbortFlags() {
+	*getMaudeAbortFlag() = true;
+}
+
+void
+clearMaudeAbortFlags() {
+	*getMaudeAbortFlag() = false;
+}
+
+CancellationToken* CancellationToken::current = nullptr;
+
+CancellationToken::CancellationToken(double timeout)
+ : timeout(timeout)
+{
+}
+
+CancellationToken::~CancellationToken() {
+	if (active)
+		deactivate();
+}
+
+void
+CancellationToken::abortEngine() {
+	setMaudeAbortFlags();
+	// The abort flag is only checked when tracing is enabled
+	UserLevelRewritingContext::setTraceStatus(true);
+}
+
+void
+CancellationToken::restoreEngine() {
+	clearMaudeAbortFlags();
+	refreshTraceStatus();
+}
+
+void
+CancellationToken::cancel() {
+	lock_guard<mutex> lock(watchMutex);
+	cancelled = true;
+
+	if (active)
+		abortEngine();
+}
+
+void
+CancellationToken::watch() {
+	unique_lock<mutex> lock(watchMutex);
+
+	if (watchCondition.wait_until(lock, deadline, [this] { return stopping; }))
+		return;
+
+	expired = true;
+	abortEngine();
+}
+
+void
+CancellationToken::activate() {
+	if (active)
+		return;
+
+	previous = current;
+	current = this;
+
+	lock_guard<mutex> lock(watchMutex);
+	active = true;
+	stopping = false;
+	expired = false;
+
+	if (cancelled)
+		abortEngine();
+
+	else if (timeout >= 0) {
+		deadline = Clock::now() + chrono::duration_cast<Clock::duration>(chrono::duration<double>(timeout));
+		watchdog = thread(&CancellationToken::watch, this);
+	}
+}
+
+void
+CancellationToken::deactivate() {
+	if (!active)
+		return;
+
+	{
+		lock_guard<mutex> lock(watchMutex);
+		stopping = true;
+		active = false;
+	}
+
+	if (watchdog.joinable()) {
+		watchCondition.notify_one();
+		watchdog.join();
+	}
+
+	current = previous;
+
+	// The abort flag is kept if an enclosing token has been cancelled
+	if (current != nullptr && current->isCancelled())
+		abortEngine();
+	else
+		restoreEngine();
+}
@@ -0,0 +1,121 @@
+/**
+ * @file cancellation.hh
+ *
+ * Deadlines and cooperative cancellation of Maude operations.
+ */
+
+#ifndef CANCELLATION_HH
+#define CANCELLATION_HH
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/**
+ * Set the abort flag of Maude, which makes the current operation
+ * stop at the next rewrite (as Ctrl+C does).
+ *
+ * @note For internal use.
+ */
+void setMaudeAbortFlags();
+
+/**
+ * Clear the abort flag of Maude.
+ *
+ * @note For internal use.
+ */
+void clearMaudeAbortFlags();
+
+/**
+ * Token to cancel the Maude operations executed while it is active,
+ * either explicitly or when a timeout expires.
+ *
+ * Operations are stopped at rewrite granularity, leaving their results
+ * as they are when interrupted (as Ctrl+C does).
+ */
+class CancellationToken {
+public:
+	/**
+	 * Create a cancellation token.
+	 *
+	 * @param timeout Maximum time in seconds since the activation of
+	 * the token (negative for no timeout).
+	 */
+	CancellationToken(double timeout = -1);
+	~CancellationToken();
+
+	/**
+	 * Cancel the operations executed while the token is active.
+	 * It can be called from other threads.
+	 */
+	void cancel();
+
+	/**
+	 * Start a time-bounded region (operations are cancelled when
+	 * the token is cancelled or the timeout expires).
+	 */
+	void activate();
+
+	/**
+	 * End the time-bounded region.
+	 */
+	void deactivate();
+
+	/**
+	 * Whether the token is active.
+	 */
+	bool isActive() const;
+
+	/**
+	 * Whether the token has been cancelled or its timeout has expired.
+	 */
+	bool isCancelled() const;
+
+	/**
+	 * Whether the timeout has expired during the last activation.
+	 */
+	bool hasExpired() const;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	void watch();
+	static void abortEngine();
+	static void restoreEngine();
+
+	double timeout;
+	Clock::time_point deadline;
+
+	std::atomic<bool> cancelled{false};
+	std::atomic<bool> expired{false};
+	bool active = false;
+	bool stopping = false;
+
+	std::thread watchdog;
+	std::mutex watchMutex;
+	std::condition_variable watchCondition;
+
+	// Token active when this one was activated
+	CancellationToken* previous = nullptr;
+
+	static CancellationToken* current;
+};
+
+inline bool
+CancellationToken::isActive() const {
+	return active;
+}
+
+inline bool
+CancellationToken::isCancelled() const {
+	return cancelled || expired;
+}
+
+inline bool
+CancellationToken::hasExpired() const {
+	return expired;
+}
+
+#endif // CANCELLATION_HH
@@ -6,12 +6,15 @@
 
 #include "easyTerm.hh"
 #include "helper_funcs.hh"
+#include "module_cache.hh"
+#include "trace_recorder.hh"
 
 #include "mixfix.hh"
 #include "meta.hh"
 
 #include "term.hh"
 #include "dagNode.hh"
+#include "dagRoot.hh"
 #include "userLevelRewritingContext.hh"
 #include "visibleModule.hh"
 #include "interpreter.hh"
@@ -47,6 +50,7 @@
 #include "S_DagNode.hh"
 #include "S_Term.hh"
 
+#include <optional>
 #include <sstream>
 
 using namespace std;
@@ -63,15 +67,15 @@ EasyTerm::EasyTerm(DagNode* dagNode)
  : is_dag(true), is_own(false), dagNode(dagNode)
 {
 	protect();
-	link();
+	RootPool<EasyTerm>::link(this);
 }
 
 EasyTerm::~EasyTerm() {
 	// Unprotect the module this object belongs to
-	dynamic_cast<ImportModule*>(symbol()->getModule())->unprotect();
+	safeCast(ImportModule*, symbol()->getModule())->unprotect();
 
 	if (is_dag)
-		unlink();
+		RootPool<EasyTerm>::unlink(this);
 	else if (is_own)
 		term->deepSelfDestruct();
 }
@@ -259,7 +263,7 @@ EasyTerm::dagify() {
 	if (is_own) term->deepSelfDestruct();
 	dagNode = d;
 	is_dag = true;
-	link();
+	RootPool<EasyTerm>::link(this);
 }
 
 void
@@ -268,14 +272,14 @@ EasyTerm::termify() {
 	is_dag = false;
 	is_own = true;
 	term = termified;
-	unlink();
+	RootPool<EasyTerm>::unlink(this);
 }
 
 inline void
 EasyTerm::protect() {
 	// Since its module must stay alive during the lifetime of term,
 	// we protect it so that it is not garbage collected by Maude
-	dynamic_cast<ImportModule*>(symbol()->getModule())->protect();
+	safeCast(ImportModule*, symbol()->getModule())->protect();
 }
 
 EasyTerm*
@@ -301,10 +305,11 @@ EasyTerm::getDag() {
 
 void
 EasyTerm::setDag(DagNode* other) {
-	if (!is_dag && is_own) {
-		term->deepSelfDestruct();
-		term = nullptr;
+	if (!is_dag) {
+		if (is_own)
+			term->deepSelfDestruct();
 		is_dag = true;
+		RootPool<EasyTerm>::link(this);
 	}
 	dagNode = other;
 }
@@ -326,18 +331,52 @@ EasyTerm::normalize(bool full) {
 }
 
 int
-EasyTerm::reduce() {
+EasyTerm::reduce(RewriteStats* stats) {
+	// Statistics are only measured when requested
+	optional<StatsRecorder> recorder;
+	if (stats != nullptr)
+		recorder.emplace();
 	VisibleModule* vmod = dynamic_cast<VisibleModule*>(symbol()->getModule());
 
 	if (!is_dag)
 		dagify();
 
-	UserLevelRewritingContext* context = new UserLevelRewritingContext(dagNode);
+	// Look for the normal form in the cache (if enabled)
+	NormalFormCache* cache = dagNode->isReduced() ? nullptr : NormalFormCache::find(vmod);
+
+	// The ground flag is not computed for fresh DAGs
+	if (cache != nullptr) {
+		dagNode->computeBaseSortForGroundSubterms(false);
+
+		if (!dagNode->isGround())
+			cache = nullptr;
+	}
+
+	if (cache != nullptr)
+		if (DagNode* normalForm = cache->get(dagNode)) {
+			dagNode = normalForm;
+			if (stats != nullptr)
+				*stats = recorder->finish(nullptr);
+			return 0;
+		}
+
+	// Unreduced nodes are overwritten in place by the reduction,
+	// so a copy is reduced when the original is used as a key
+	UserLevelRewritingContext* context = new RecordingRewritingContext(cache != nullptr ? dagNode->copyAll() : dagNode);
 	startUsingModule(vmod);
 	context->reduce();
 
 	int rewrites = context->getTotalCount();
 
+	if (cache != nullptr) {
+		if (!UserLevelRewritingContext::aborted())
+			cache->put(dagNode, context->root());
+		dagNode = context->root();
+	}
+
+	if (stats != nullptr)
+		*stats = recorder->finish(context);
+
 	delete context;
 	(void) vmod->unprotect();
 
@@ -345,13 +384,16 @@ EasyTerm::reduce() {
 }
 
 int
-EasyTerm::rewrite(int limit) {
+EasyTerm::rewrite(int limit, RewriteStats* stats) {
+	optional<StatsRecorder> recorder;
+	if (stats != nullptr)
+		recorder.emplace();
 	VisibleModule* vmod = dynamic_cast<VisibleModule*>(symbol()->getModule());
 
 	if (!is_dag)
 		dagify();
 
-	RewritingContext* context = new UserLevelRewritingContext(dagNode);
+	RewritingContext* context = new RecordingRewritingContext(dagNode);
 
 	if (interpreter.getFlag(Interpreter::AUTO_CLEAR_RULES))
 		vmod->resetRules();
@@ -362,6 +404,9 @@ EasyTerm::rewrite(int limit) {
 	int rewrites = context->getTotalCount();
 	dagNode = context->root();
 
+	if (stats != nullptr)
+		*stats = recorder->finish(context);
+
 	delete context;
 	(void) vmod->unprotect();
 
@@ -369,13 +414,16 @@ EasyTerm::rewrite(int limit) {
 }
 
 int
-EasyTerm::frewrite(int limit, int gas) {
+EasyTerm::frewrite(int limit, int gas, RewriteStats* stats) {
+	optional<StatsRecorder> recorder;
+	if (stats != nullptr)
+		recorder.emplace();
 	VisibleModule* vmod = dynamic_cast<VisibleModule*>(symbol()->getModule());
 
 	if (!is_dag)
 		dagify();
 
-	UserLevelRewritingContext* context = new UserLevelRewritingContext(dagNode);
+	UserLevelRewritingContext* context = new RecordingRewritingContext(dagNode);
 	context->setObjectMode(ObjectSystemRewritingContext::FAIR);
 	if (interpreter.getFlag(Interpreter::AUTO_CLEAR_RULES))
 		vmod->resetRules();
@@ -385,12 +433,127 @@ EasyTerm::frewrite(int limit, int gas) {
 	int rewrites = context->getTotalCount();
 	dagNode = context->root();
 
+	if (stats != nullptr)
+		*stats = recorder->finish(context);
+
 	delete context;
 	(void) vmod->unprotect();
 
 	return rewrites;
 }
 
+vector<pair<VisibleModule*, vector<size_t>>>
+EasyTerm::groupByModule(const vector<EasyTerm*> &terms) {
+	vector<pair<VisibleModule*, vector<size_t>>> groups;
+	map<VisibleModule*, size_t> groupIndex;
+
+	for (size_t i = 0; i < terms.size(); i++) {
+		VisibleModule* vmod = dynamic_cast<VisibleModule*>(terms[i]->symbol()->getModule());
+		auto [it, inserted] = groupIndex.insert({vmod, groups.size()});
+
+		if (inserted)
+			groups.push_back({vmod, {}});
+
+		groups[it->second].second.push_back(i);
+	}
+
+	return groups;
+}
+
+vector<int>
+EasyTerm::reduceMany(const vector<EasyTerm*> &terms) {
+	vector<int> rewrites(terms.size(), 0);
+
+	for (auto &[vmod, indices] : groupByModule(terms)) {
+		for (size_t i : indices)
+			if (!terms[i]->is_dag)
+				terms[i]->dagify();
+
+		// A single context is shared by all the terms of the module,
+		// which are reduced in place (they are protected by their
+		// EasyTerm wrappers, so the context root is irrelevant)
+		RecordingRewritingContext context(terms[indices[0]]->dagNode);
+		NormalFormCache* cache = NormalFormCache::find(vmod);
+		startUsingModule(vmod);
+
+		for (size_t i : indices) {
+			DagNode* dagNode = terms[i]->dagNode;
+			context.clearCount();
+
+			bool cacheable = cache != nullptr && !dagNode->isReduced();
+
+			if (cacheable) {
+				dagNode->computeBaseSortForGroundSubterms(false);
+				cacheable = dagNode->isGround();
+			}
+
+			if (!cacheable)
+				dagNode->reduce(context);
+
+			else if (DagNode* normalForm = cache->get(dagNode))
+				terms[i]->dagNode = normalForm;
+
+			else {
+				// The original term is kept unreduced as the key
+				DagRoot normalForm(dagNode->copyAll());
+				normalForm.getNode()->reduce(context);
+
+				if (!UserLevelRewritingContext::aborted())
+					cache->put(dagNode, normalForm.getNode());
+				terms[i]->dagNode = normalForm.getNode();
+			}
+
+			rewrites[i] = context.getTotalCount();
+
+			// The remaining terms (of any module) are left untouched
+			if (UserLevelRewritingContext::aborted()) {
+				(void) vmod->unprotect();
+				return rewrites;
+			}
+		}
+
+		(void) vmod->unprotect();
+	}
+
+	return rewrites;
+}
+
+vector<int>
+EasyTerm::rewriteMany(const vector<EasyTerm*> &terms, int limit) {
+	vector<int> rewrites(terms.size(), 0);
+
+	for (auto &[vmod, indices] : groupByModule(terms)) {
+		if (interpreter.getFlag(Interpreter::AUTO_CLEAR_RULES))
+			vmod->resetRules();
+		startUsingModule(vmod);
+
+		for (size_t i : indices) {
+			EasyTerm* term = terms[i];
+
+			if (!term->is_dag)
+				term->dagify();
+
+			// Rule rewriting replaces the root of the context,
+			// so a context is needed for each term
+			RecordingRewritingContext context(term->dagNode);
+			context.ruleRewrite(limit);
+
+			rewrites[i] = context.getTotalCount();
+			term->dagNode = context.root();
+
+			// The remaining terms (of any module) are left untouched
+			if (UserLevelRewritingContext::aborted()) {
+				(void) vmod->unprotect();
+				return rewrites;
+			}
+		}
+
+		(void) vmod->unprotect();
+	}
+
+	return rewrites;
+}
+
 pair<EasyTerm*, int>
 EasyTerm::erewrite(int limit, int gas) {
 	VisibleModule* vmod = dynamic_cast<VisibleModule*>(symbol()->getModule());
@@ -398,7 +561,7 @@ EasyTerm::erewrite(int limit, int gas) {
 	if (!is_dag)
 		dagify();
 
-	UserLevelRewritingContext* context = new UserLevelRewritingContext(dagNode);
+	UserLevelRewritingContext* context = new RecordingRewritingContext(dagNode);
 	context->setObjectMode(ObjectSystemRewritingContext::EXTERNAL);
 	if (interpreter.getFlag(Interpreter::AUTO_CLEAR_RULES))
 		vmod->resetRules();
@@ -432,7 +595,7 @@ EasyTerm::srewrite(StrategyExpression* expr, bool depthSearch) {
 
 	strategy->process();
 
-	UserLevelRewritingContext* context = new UserLevelRewritingContext(dagNode);
+	UserLevelRewritingContext* context = new RecordingRewritingContext(dagNode);
 	context->setObjectMode(ObjectSystemRewritingContext::EXTERNAL);
 	if (interpreter.getFlag(Interpreter::AUTO_CLEAR_RULES))
 		vmod->resetRules();
@@ -499,7 +662,7 @@ EasyTerm::search(SearchType type,
 	Pattern* pattern = new Pattern(target->termCopy(), false, conditionCopy);
 
 	RewriteSequenceSearch* state =
-		new RewriteSequenceSearch(new UserLevelRewritingContext(getDag()),
+		new RewriteSequenceSearch(new RecordingRewritingContext(getDag()),
 				  static_cast<RewriteSequenceSearch::SearchType>(type),
 				  pattern,
 				  depth);
@@ -536,7 +699,7 @@ EasyTerm::search(SearchType type,
 	Pattern* pattern = new Pattern(target->termCopy(), false, conditionCopy);
 
 	StrategySequenceSearch* state =
-		new StrategySequenceSearch(new UserLevelRewritingContext(getDag()),
+		new StrategySequenceSearch(new RecordingRewritingContext(getDag()),
 				  static_cast<RewriteSequenceSearch::SearchType>(type),
 				  pattern,
 				  stratCopy,
@@ -721,7 +884,7 @@ EasySubstitution::EasySubstitution(const Substitution* subs,
 		mapping[{var->id(), var->symbol()->getRangeSort()}] = subs->value(i);
 	}
 
-	link();
+	RootPool<EasySubstitution>::link(this);
 }
 
 EasySubstitution::EasySubstitution(const Substitution* subs,
@@ -732,7 +895,7 @@ EasySubstitution::EasySubstitution(const Substitution* subs,
 		mapping[{var->id(), var->symbol()->getRangeSort()}] = subs->value(i);
 	}
 
-	link();
+	RootPool<EasySubstitution>::link(this);
 }
 
 EasySubstitution::EasySubstitution(const vector<EasyTerm*> &variables,
@@ -746,12 +909,12 @@ EasySubstitution::EasySubstitution(const vector<EasyTerm*> &variables,
 			mapping[{var->id(), var->symbol()->getRangeSort()}] = values[i]->getDag();
 	}
 
-	link();
+	RootPool<EasySubstitution>::link(this);
 }
 
 EasySubstitution::~EasySubstitution() {
 	mapping.clear();
-	unlink();
+	RootPool<EasySubstitution>::unlink(this);
 }
 
 int
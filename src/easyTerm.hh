@@ -15,13 +15,14 @@
 #include "strategyLanguage.hh"
 #include "higher.hh"
 #include "mixfix.hh"
-#include "rootContainer.hh"
+#include "root_pool.hh"
 #include "vector.hh"
 #include "interpreter.hh"
 #include "term.hh"
 #include "argumentIterator.hh"
 #include "dagArgumentIterator.hh"
 #include "narrowingSequenceSearch3.hh"
+#include "statistics.hh"
 
 #include <iostream>
 #include <vector>
@@ -54,6 +55,23 @@ enum NarrowingFlags {
 	FILTER = VariantUnificationProblem::FILTER_VARIANT_UNIFIERS,
 };
 
+/**
+ * Flat preorder representation of a term.
+ *
+ * The entries at the same position of the symbols, arities, numbers and
+ * texts vectors describe a node of the term. Subterms shared in the DAG
+ * are only expanded the first time they are found, and referenced later.
+ */
+struct FlatTerm {
+	/// Index of the symbol within its module, or -(k+1) for a reference
+	/// to the subterm already expanded at position k.
+	std::vector<int> symbols;
+	std::vector<int> arities;		///< Number of arguments of each node.
+	std::vector<double> numbers;		///< Numeric payload of built-in constants (NaN if none).
+	std::vector<int> texts;			///< Position of the textual payload in strings (-1 if none).
+	std::vector<std::string> strings;	///< Distinct textual payloads.
+};
+
 /*
  * Forward declaration of EasySubstitution and
  * EasyArgumentIterator to be used in EasyTerm.
@@ -64,7 +82,7 @@ class EasyArgumentIterator;
 /**
  * Maude term with its associated operations.
  */
-class EasyTerm : public RootContainer {
+class EasyTerm {
 public:
 	/**
 	 * Create a simplified term from an internal tree representation.
@@ -120,28 +138,58 @@ public:
 	/**
 	 * Reduce this term.
 	 *
+	 * @param stats If not null, where to store the statistics of the call.
+	 *
 	 * @return The total number of rewrites.
 	 */
-	int reduce();
+	int reduce(RewriteStats* stats = nullptr);
 
 	/**
 	 * Rewrite a term following the semantics of the @c rewrite command.
 	 *
 	 * @param bound An upper bound on the number of rule rewrites.
+	 * @param stats If not null, where to store the statistics of the call.
 	 *
 	 * @return The total number of rewrites.
 	 */
-	int rewrite(int bound = -1);
+	int rewrite(int bound = -1, RewriteStats* stats = nullptr);
 
 	/**
 	 * Rewrite a term following the semantics of the @c frewrite command.
 	 *
 	 * @param bound An upper bound on the number of rule rewrites.
 	 * @param gas An upper bound on the number of rule rewrites per position.
+	 * @param stats If not null, where to store the statistics of the call.
 	 *
 	 * @return The total number of rewrites.
 	 */
-	int frewrite(int bound = -1, int gas = -1);
+	int frewrite(int bound = -1, int gas = -1, RewriteStats* stats = nullptr);
+
+	/**
+	 * Reduce many terms at once.
+	 *
+	 * Terms are grouped by module so that the module bookkeeping is
+	 * done once per module and a single rewriting context is shared
+	 * by all the terms in each group.
+	 *
+	 * @param terms The terms to be reduced (in place).
+	 *
+	 * @return The total number of rewrites for each term (the terms
+	 * after an aborted one are not reduced and have no rewrites).
+	 */
+	static std::vector<int> reduceMany(const std::vector<EasyTerm*> &terms);
+
+	/**
+	 * Rewrite many terms at once following the semantics of the
+	 * @c rewrite command.
+	 *
+	 * @param terms The terms to be rewritten (in place).
+	 * @param bound An upper bound on the number of rule rewrites per term.
+	 *
+	 * @return The total number of rewrites for each term (the terms
+	 * after an aborted one are not rewritten and have no rewrites).
+	 */
+	static std::vector<int> rewriteMany(const std::vector<EasyTerm*> &terms, int bound = -1);
 
 	/**
 	 * Rewrite a term following the semantics of the @c erewrite command.
@@ -349,6 +397,34 @@ public:
 	 */
 	std::string toLatex() const;
 
+	/**
+	 * Serialize this term into a compact binary representation
+	 * (preserving sharing) that can be read with deserialize.
+	 *
+	 * @return The serialized term or an empty string if it
+	 * contains unsupported built-in constants.
+	 */
+	std::string serialize();
+
+	/**
+	 * Rebuild a term from its serialized representation.
+	 *
+	 * @param vmod Module where the term is built or null to look it
+	 * up by the name stored in the serialized data.
+	 * @param serialized The serialized representation of the term.
+	 *
+	 * @return The term or null if the data is not valid.
+	 */
+	static EasyTerm* deserialize(VisibleModule* vmod, const std::string &serialized);
+
+	/**
+	 * Export this term as a flat preorder sequence of nodes, without
+	 * creating intermediate term objects.
+	 *
+	 * @return A new flat term (ownership is transferred to the caller).
+	 */
+	FlatTerm* flatten();
+
 	/**
 	 * An empty condition to be used as a placeholder.
 	 */
@@ -359,6 +435,12 @@ public:
 	static void startUsingModule(VisibleModule* vmod);
 
 private:
+	/**
+	 * Group terms by module (in order of first appearance).
+	 */
+	static std::vector<std::pair<VisibleModule*, std::vector<size_t>>>
+	groupByModule(const std::vector<EasyTerm*> &terms);
+
 	void dagify();
 	void termify();
 	void protect();
@@ -369,12 +451,17 @@ private:
 		DagNode* dagNode;
 		Term* term;
 	};
+
+	// Position in the pool of roots (only in DAG form)
+	size_t rootSlot;
+
+	friend class RootPool<EasyTerm>;
 };
 
 /**
  * Substitution (mapping from variables to terms).
  */
-class EasySubstitution : private RootContainer {
+class EasySubstitution {
 public:
 	EasySubstitution(const Substitution* subs,
 			 const VariableInfo* vinfo,
@@ -456,6 +543,24 @@ private:
 
 	Mapping mapping;
 	const ExtensionInfo* extension;
+
+	// Position in the pool of roots
+	size_t rootSlot;
+
+	friend class RootPool<EasySubstitution>;
+};
+
+/**
+ * Solution of a search in a page of results.
+ *
+ * Fields that do not apply to the search are null or @c -1.
+ */
+struct SearchSolution {
+	EasyTerm* term;			///< Solution term.
+	EasySubstitution* substitution;	///< Matching substitution or unifier.
+	EasySubstitution* unifier;	///< Variant unifier (only for narrowing).
+	int stateNr;			///< Number of the solution state in the search graph.
+	long long rewrites;		///< Number of rewrites until the solution.
 };
 
 class EasyArgumentIterator : private std::variant<DagArgumentIterator, ArgumentIterator>
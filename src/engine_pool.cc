@@ -0,0 +1,671 @@
+/**
+ * @file engine_pool.cc
+ *
+ * Pool of forked Maude processes to distribute work among cores.
+ */
+
+#include "macros.hh"
+#include "core.hh"
+#include "interface.hh"
+#include "mixfix.hh"
+#include "higher.hh"
+
+#include "visibleModule.hh"
+#include "userLevelRewritingContext.hh"
+#include "rewriteSequenceSearch.hh"
+
+#include "engine_pool.hh"
+#include "maude_wrappers.hh"
+
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifndef _WIN32
+// Milliseconds between checks of the abort flag while waiting for workers
+const int ABORT_POLL_INTERVAL = 100;
+#endif
+
+//
+// Messages
+//
+
+PoolMessage::PoolMessage(string data)
+ : buffer(std::move(data))
+{
+}
+
+void
+PoolMessage::putInt(long long value) {
+	buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void
+PoolMessage::putDouble(double value) {
+	buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void
+PoolMessage::putString(const string &str) {
+	putInt(str.size());
+	buffer.append(str);
+}
+
+void
+PoolMessage::putTerm(EasyTerm* term) {
+	putString(term->serialize());
+}
+
+long long
+PoolMessage::getInt() {
+	long long value = 0;
+
+	if (position + sizeof(value) <= buffer.size()) {
+		memcpy(&value, buffer.data() + position, sizeof(value));
+		position += sizeof(value);
+	}
+
+	return value;
+}
+
+double
+PoolMessage::getDouble() {
+	double value = 0.0;
+
+	if (position + sizeof(value) <= buffer.size()) {
+		memcpy(&value, buffer.data() + position, sizeof(value));
+		position += sizeof(value);
+	}
+
+	return value;
+}
+
+string
+PoolMessage::getString() {
+	size_t length = getInt();
+
+	if (position + length > buffer.size())
+		length = buffer.size() - position;
+
+	string str = buffer.substr(position, length);
+	position += length;
+	return str;
+}
+
+EasyTerm*
+PoolMessage::getTerm(VisibleModule* vmod) {
+	// The module is looked up by its name (stored in the
+	// serialized term) when not given
+	return EasyTerm::deserialize(vmod, getString());
+}
+
+bool
+PoolMessage::atEnd() const {
+	return position >= buffer.size();
+}
+
+const string &
+PoolMessage::data() const {
+	return buffer;
+}
+
+void
+PoolMessage::clear() {
+	buffer.clear();
+	position = 0;
+}
+
+//
+// Builtin jobs
+//
+
+static bool
+reduceJob(PoolMessage &request, PoolMessage &reply) {
+	EasyTerm* term = request.getTerm();
+
+	if (term == nullptr)
+		return false;
+
+	int rewrites = term->reduce();
+
+	reply.putTerm(term);
+	reply.putInt(rewrites);
+
+	delete term;
+	return true;
+}
+
+static bool
+rewriteJob(PoolMessage &request, PoolMessage &reply) {
+	EasyTerm* term = request.getTerm();
+	int bound = request.getInt();
+
+	if (term == nullptr)
+		return false;
+
+	int rewrites = term->rewrite(bound);
+
+	reply.putTerm(term);
+	reply.putInt(rewrites);
+
+	delete term;
+	return true;
+}
+
+static bool
+frewriteJob(PoolMessage &request, PoolMessage &reply) {
+	EasyTerm* term = request.getTerm();
+	int bound = request.getInt();
+	int gas = request.getInt();
+
+	if (term == nullptr)
+		return false;
+
+	int rewrites = term->frewrite(bound, gas);
+
+	reply.putTerm(term);
+	reply.putInt(rewrites);
+
+	delete term;
+	return true;
+}
+
+static bool
+searchJob(PoolMessage &request, PoolMessage &reply) {
+	EasyTerm* term = request.getTerm();
+
+	if (term == nullptr)
+		return false;
+
+	VisibleModule* vmod = safeCast(VisibleModule*, term->symbol()->getModule());
+	EasyTerm* target = request.getTerm(vmod);
+	SearchType type = SearchType(request.getInt());
+	int depth = request.getInt();
+	long long maxSolutions = request.getInt();
+
+	RewriteSequenceSearch* search = target != nullptr
+		? term->search(type, target, EasyTerm::NO_CONDITION, depth)
+		: nullptr;
+
+	if (search == nullptr) {
+		delete target;
+		delete term;
+		return false;
+	}
+
+	// Each solution is preceded by a nonzero mark
+	for (long long nrSolutions = 0; nrSolutions != maxSolutions && search->findNextMatch(); nrSolutions++) {
+		EasyTerm solution(search->getStateDag(search->getStateNr()));
+		reply.putInt(1);
+		reply.putTerm(&solution);
+	}
+
+	reply.putInt(0);
+	reply.putInt(search->getContext()->getTotalCount());
+
+	vmod->unprotect();
+	delete search;
+	delete target;
+	delete term;
+
+	return true;
+}
+
+[[maybe_unused]] static bool builtinJobsRegistered =
+	EnginePool::registerJob(EnginePool::REDUCE_JOB, reduceJob) &&
+	EnginePool::registerJob(EnginePool::REWRITE_JOB, rewriteJob) &&
+	EnginePool::registerJob(EnginePool::FREWRITE_JOB, frewriteJob) &&
+	EnginePool::registerJob(EnginePool::SEARCH_JOB, searchJob);
+
+//
+// Pipe communication
+//
+
+#ifndef _WIN32
+
+static bool
+writeAll(int fd, const char* data, size_t length) {
+	while (length > 0) {
+		ssize_t written = write(fd, data, length);
+
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+
+		data += written;
+		length -= written;
+	}
+
+	return true;
+}
+
+static bool
+readAll(int fd, char* data, size_t length) {
+	while (length > 0) {
+		ssize_t nread = read(fd, data, length);
+
+		if (nread < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		else if (nread == 0)
+			return false;
+
+		data += nread;
+		length -= nread;
+	}
+
+	return true;
+}
+
+// Messages are preceded by their length
+static bool
+writeMessage(int fd, const string &data) {
+	uint64_t length = data.size();
+	return writeAll(fd, reinterpret_cast<const char*>(&length), sizeof(length))
+		&& writeAll(fd, data.data(), length);
+}
+
+static bool
+readMessage(int fd, string &data) {
+	uint64_t length;
+
+	if (!readAll(fd, reinterpret_cast<char*>(&length), sizeof(length)))
+		return false;
+
+	data.resize(length);
+	return readAll(fd, data.data(), length);
+}
+
+#endif
+
+//
+// Engine pool
+//
+
+map<int, EnginePool::JobHandler> &
+EnginePool::jobHandlers() {
+	static map<int, JobHandler> handlers;
+	return handlers;
+}
+
+bool
+EnginePool::registerJob(int type, JobHandler handler) {
+	return jobHandlers().insert({type, handler}).second;
+}
+
+void
+EnginePool::runJob(PoolMessage &request, PoolMessage &reply) {
+	auto &handlers = jobHandlers();
+	auto it = handlers.find(request.getInt());
+
+	reply.putInt(JOB_SUCCEEDED);
+
+	if (it == handlers.end() || !it->second(request, reply)) {
+		reply.clear();
+		reply.putInt(JOB_FAILED);
+	}
+}
+
+EnginePool::EnginePool(int nrWorkers) {
+	if (nrWorkers < 0)
+		nrWorkers = max(1u, thread::hardware_concurrency());
+
+#ifdef _WIN32
+	if (nrWorkers > 0)
+		IssueWarning("worker processes are not supported in this platform, jobs will be executed locally.");
+#else
+	// A broken pipe should not terminate the process
+	struct sigaction sigact;
+	sigaction(SIGPIPE, nullptr, &sigact);
+
+	if (sigact.sa_handler == SIG_DFL) {
+		sigact.sa_handler = SIG_IGN;
+		sigaction(SIGPIPE, &sigact, nullptr);
+	}
+
+	workers.reserve(nrWorkers);
+
+	for (int i = 0; i < nrWorkers; i++)
+		if (!spawnWorker()) {
+			IssueWarning("cannot create worker process: " << strerror(errno) << ".");
+			break;
+		}
+#endif
+}
+
+EnginePool::~EnginePool() {
+	shutdown();
+}
+
+int
+EnginePool::getNrWorkers() const {
+	return workers.size();
+}
+
+bool
+EnginePool::spawnWorker() {
+#ifdef _WIN32
+	return false;
+#else
+	int toWorker[2], fromWorker[2];
+
+	if (pipe(toWorker) != 0)
+		return false;
+
+	if (pipe(fromWorker) != 0) {
+		close(toWorker[0]);
+		close(toWorker[1]);
+		return false;
+	}
+
+	pid_t pid = fork();
+
+	if (pid < 0) {
+		close(toWorker[0]);
+		close(toWorker[1]);
+		close(fromWorker[0]);
+		close(fromWorker[1]);
+		return false;
+	}
+
+	if (pid == 0) {
+		// The pipes of the other workers are closed, so that they
+		// receive end of file when the parent closes them
+		for (const Worker &worker : workers) {
+			close(worker.input);
+			close(worker.output);
+		}
+
+		close(toWorker[1]);
+		close(fromWorker[0]);
+
+		// Interrupts are handled by the parent
+		signal(SIGINT, SIG_IGN);
+
+		workerLoop(toWorker[0], fromWorker[1]);
+	}
+
+	close(toWorker[0]);
+	close(fromWorker[1]);
+
+	// The parent ends should not be inherited by other processes
+	fcntl(toWorker[1], F_SETFD, FD_CLOEXEC);
+	fcntl(fromWorker[0], F_SETFD, FD_CLOEXEC);
+
+	workers.push_back({pid, toWorker[1], fromWorker[0]});
+	return true;
+#endif
+}
+
+void
+EnginePool::workerLoop(int input, int output) {
+#ifndef _WIN32
+	string data;
+
+	while (readMessage(input, data)) {
+		PoolMessage request(std::move(data)), reply;
+		runJob(request, reply);
+
+		if (!writeMessage(output, reply.data()))
+			break;
+	}
+
+	// Exit without running destructors or flushing buffers
+	// duplicated from the parent process
+	_exit(0);
+#endif
+}
+
+void
+EnginePool::killWorker(size_t index) {
+#ifndef _WIN32
+	Worker &worker = workers[index];
+
+	kill(worker.pid, SIGKILL);
+	close(worker.input);
+	close(worker.output);
+	waitpid(worker.pid, nullptr, 0);
+
+	workers.erase(workers.begin() + index);
+#endif
+}
+
+void
+EnginePool::shutdown() {
+#ifndef _WIN32
+	// Workers terminate when their input is closed
+	for (const Worker &worker : workers)
+		close(worker.input);
+
+	for (const Worker &worker : workers) {
+		waitpid(worker.pid, nullptr, 0);
+		close(worker.output);
+	}
+
+	workers.clear();
+#endif
+}
+
+vector<PoolMessage>
+EnginePool::execute(vector<PoolMessage> &requests) {
+	size_t nrJobs = requests.size();
+	vector<PoolMessage> replies(nrJobs);
+
+	// Jobs are executed locally if there are no workers
+	if (workers.empty()) {
+		for (size_t i = 0; i < nrJobs; i++)
+			runJob(requests[i], replies[i]);
+	}
+	else
+		collectReplies(requests, replies, false);
+
+	return replies;
+}
+
+vector<PoolMessage>
+EnginePool::executeOnEach(vector<PoolMessage> &requests) {
+	size_t nrJobs = requests.size();
+	vector<PoolMessage> replies(nrJobs);
+
+	if (workers.empty()) {
+		for (size_t i = 0; i < nrJobs; i++)
+			runJob(requests[i], replies[i]);
+	}
+	else
+		collectReplies(requests, replies, true);
+
+	return replies;
+}
+
+void
+EnginePool::collectReplies(vector<PoolMessage> &requests, vector<PoolMessage> &replies,
+                           bool fixedAssignment) {
+#ifndef _WIN32
+	size_t nrJobs = requests.size();
+	const size_t NO_JOB = nrJobs;
+	size_t nrWorkers = workers.size();
+
+	vector<size_t> assigned(nrWorkers, NO_JOB);
+	vector<bool> alive(nrWorkers, true), dispatched(nrJobs, false);
+	size_t nextJob = 0, pending = 0;
+
+	// Send the next job to the given worker (with a fixed assignment,
+	// the worker only receives the job with its own index)
+	auto dispatch = [&](size_t w) {
+		size_t job = fixedAssignment ? w : nextJob;
+
+		if (job < nrJobs && !dispatched[job]) {
+			dispatched[job] = true;
+			nextJob++;
+
+			if (writeMessage(workers[w].input, requests[job].data())) {
+				assigned[w] = job;
+				pending++;
+			}
+			else {
+				replies[job].putInt(JOB_FAILED);
+				alive[w] = false;
+			}
+		}
+	};
+
+	for (size_t w = 0; w < nrWorkers; w++)
+		dispatch(w);
+
+	vector<pollfd> fds;
+	vector<size_t> fdWorker;
+
+	while (pending > 0) {
+		fds.clear();
+		fdWorker.clear();
+
+		for (size_t w = 0; w < nrWorkers; w++)
+			if (assigned[w] != NO_JOB) {
+				fds.push_back({workers[w].output, POLLIN, 0});
+				fdWorker.push_back(w);
+			}
+
+		int nrReady = poll(fds.data(), fds.size(), ABORT_POLL_INTERVAL);
+
+		if (nrReady < 0) {
+			// The operation can be interrupted by the user
+			if (errno == EINTR && !UserLevelRewritingContext::aborted())
+				continue;
+			break;
+		}
+
+		// The abort flag may also be set by a cancellation token
+		if (UserLevelRewritingContext::aborted())
+			break;
+
+		for (size_t k = 0; k < fds.size(); k++) {
+			if (fds[k].revents == 0)
+				continue;
+
+			size_t w = fdWorker[k];
+			size_t job = assigned[w];
+			string data;
+
+			assigned[w] = NO_JOB;
+			pending--;
+
+			if (readMessage(workers[w].output, data)) {
+				replies[job] = PoolMessage(std::move(data));
+				dispatch(w);
+			}
+			else {
+				replies[job].putInt(JOB_FAILED);
+				alive[w] = false;
+			}
+		}
+	}
+
+	// Jobs still running (if interrupted) or never dispatched (if
+	// all workers have died) are marked as failed
+	for (size_t w = 0; w < nrWorkers; w++)
+		if (assigned[w] != NO_JOB) {
+			replies[assigned[w]].putInt(JOB_FAILED);
+			alive[w] = false;
+		}
+
+	for (size_t job = 0; job < nrJobs; job++)
+		if (!dispatched[job])
+			replies[job].putInt(JOB_FAILED);
+
+	// Remove the dead or interrupted workers
+	for (size_t w = nrWorkers; w-- > 0;)
+		if (!alive[w]) {
+			IssueWarning("worker process " << workers[w].pid << " has been terminated.");
+			killWorker(w);
+		}
+#endif
+}
+
+vector<pair<EasyTerm*, int>>
+EnginePool::rewriteBatch(JobType type, const vector<EasyTerm*> &terms, int bound, int gas) {
+	size_t nrTerms = terms.size();
+	vector<PoolMessage> requests(nrTerms);
+
+	for (size_t i = 0; i < nrTerms; i++) {
+		requests[i].putInt(type);
+		requests[i].putTerm(terms[i]);
+
+		if (type != REDUCE_JOB)
+			requests[i].putInt(bound);
+		if (type == FREWRITE_JOB)
+			requests[i].putInt(gas);
+	}
+
+	vector<PoolMessage> replies = execute(requests);
+	vector<pair<EasyTerm*, int>> results(nrTerms, {nullptr, -1});
+
+	for (size_t i = 0; i < nrTerms; i++)
+		if (replies[i].getInt() == JOB_SUCCEEDED) {
+			VisibleModule* vmod = safeCast(VisibleModule*, terms[i]->symbol()->getModule());
+			EasyTerm* result = replies[i].getTerm(vmod);
+			results[i] = {result, replies[i].getInt()};
+		}
+
+	return results;
+}
+
+vector<pair<EasyTerm*, int>>
+EnginePool::reduce(const vector<EasyTerm*> &terms) {
+	return rewriteBatch(REDUCE_JOB, terms, 0, 0);
+}
+
+vector<pair<EasyTerm*, int>>
+EnginePool::rewrite(const vector<EasyTerm*> &terms, int bound) {
+	return rewriteBatch(REWRITE_JOB, terms, bound, 0);
+}
+
+vector<pair<EasyTerm*, int>>
+EnginePool::frewrite(const vector<EasyTerm*> &terms, int bound, int gas) {
+	return rewriteBatch(FREWRITE_JOB, terms, bound, gas);
+}
+
+vector<vector<EasyTerm*>>
+EnginePool::search(const vector<EasyTerm*> &terms, SearchType type, EasyTerm* target,
+                   int depth, int maxSolutions) {
+	size_t nrTerms = terms.size();
+	vector<PoolMessage> requests(nrTerms);
+
+	for (size_t i = 0; i < nrTerms; i++) {
+		requests[i].putInt(SEARCH_JOB);
+		requests[i].putTerm(terms[i]);
+		requests[i].putTerm(target);
+		requests[i].putInt(type);
+		requests[i].putInt(depth);
+		requests[i].putInt(maxSolutions);
+	}
+
+	vector<PoolMessage> replies = execute(requests);
+	vector<vector<EasyTerm*>> results(nrTerms);
+
+	for (size_t i = 0; i < nrTerms; i++) {
+		if (replies[i].getInt() != JOB_SUCCEEDED)
+			continue;
+
+		VisibleModule* vmod = safeCast(VisibleModule*, terms[i]->symbol()->getModule());
+
+		while (replies[i].getInt() != 0)
+			if (EasyTerm* solution = replies[i].getTerm(vmod))
+				results[i].push_back(solution);
+	}
+
+	return results;
+}
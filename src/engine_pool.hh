@@ -0,0 +1,180 @@
+/**
+ * @file engine_pool.hh
+ *
+ * Pool of forked Maude processes to distribute work among cores.
+ */
+
+#ifndef ENGINE_POOL_HH
+#define ENGINE_POOL_HH
+
+#include "easyTerm.hh"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Binary message exchanged between the pool and its workers.
+ */
+class PoolMessage {
+public:
+	PoolMessage() = default;
+	PoolMessage(std::string data);
+
+	void putInt(long long value);
+	void putDouble(double value);
+	void putString(const std::string &str);
+	/**
+	 * Write a term in its serialized form.
+	 */
+	void putTerm(EasyTerm* term);
+
+	long long getInt();
+	double getDouble();
+	std::string getString();
+	/**
+	 * Read a term in the given module (or in the module
+	 * whose name is included in the serialized term if null).
+	 */
+	EasyTerm* getTerm(VisibleModule* vmod = nullptr);
+
+	bool atEnd() const;
+	const std::string &data() const;
+	void clear();
+
+private:
+	std::string buffer;
+	size_t position = 0;
+};
+
+/**
+ * Pool of worker processes forked from the current one.
+ *
+ * Workers share the modules loaded before the creation of the pool
+ * (copy on write) and execute jobs sent through pipes. Modules
+ * loaded or replaced afterwards are not visible to the workers.
+ */
+class EnginePool {
+public:
+	/**
+	 * Job types executed by the workers.
+	 */
+	enum JobType {
+		REDUCE_JOB,
+		REWRITE_JOB,
+		FREWRITE_JOB,
+		SEARCH_JOB,
+		PSEARCH_START_JOB,	///< Start a partition of a parallel search
+		PSEARCH_STEP_JOB,	///< Expand a level of a parallel search
+		PSEARCH_END_JOB,	///< Discard a partition of a parallel search
+		SIMULATE_JOB,		///< Execute a batch of random simulation runs
+		SMC_JOB,		///< Check a formula on a batch of random executions
+	};
+
+	/**
+	 * Status of a job reply.
+	 */
+	enum JobStatus {
+		JOB_SUCCEEDED,
+		JOB_FAILED,
+	};
+
+	/**
+	 * Job handler that reads a request and writes its reply.
+	 *
+	 * @return Whether the job succeeded.
+	 */
+	typedef bool (*JobHandler)(PoolMessage &request, PoolMessage &reply);
+
+	/**
+	 * Create a pool of workers.
+	 *
+	 * @param nrWorkers Number of worker processes (@c -1 for as many as
+	 * available cores, @c 0 to execute the jobs in the current process).
+	 */
+	EnginePool(int nrWorkers = -1);
+	~EnginePool();
+
+	/**
+	 * Get the number of alive workers.
+	 */
+	int getNrWorkers() const;
+
+	/**
+	 * Reduce the given terms in parallel.
+	 *
+	 * @return The reduced terms (or null if the job failed) and
+	 * their numbers of rewrites.
+	 */
+	std::vector<std::pair<EasyTerm*, int>> reduce(const std::vector<EasyTerm*> &terms);
+
+	/**
+	 * Rewrite the given terms in parallel with the @c rewrite command.
+	 */
+	std::vector<std::pair<EasyTerm*, int>> rewrite(const std::vector<EasyTerm*> &terms, int bound = -1);
+
+	/**
+	 * Rewrite the given terms in parallel with the @c frewrite command.
+	 */
+	std::vector<std::pair<EasyTerm*, int>> frewrite(const std::vector<EasyTerm*> &terms,
+	                                                int bound = -1, int gas = -1);
+
+	/**
+	 * Search from each of the given terms in parallel.
+	 *
+	 * @return The solutions for each initial term.
+	 */
+	std::vector<std::vector<EasyTerm*>> search(const std::vector<EasyTerm*> &terms,
+	                                           SearchType type, EasyTerm* target,
+	                                           int depth = -1, int maxSolutions = -1);
+
+	/**
+	 * Terminate all the workers.
+	 */
+	void shutdown();
+
+	/**
+	 * Execute a batch of jobs distributing them among the workers.
+	 *
+	 * Each request starts with its job type. Replies start with a
+	 * status flag (zero if the job succeeded).
+	 */
+	std::vector<PoolMessage> execute(std::vector<PoolMessage> &requests);
+
+	/**
+	 * Execute a batch of jobs sending the i-th request to the i-th worker.
+	 *
+	 * Jobs are executed locally if there are no workers. Requests
+	 * beyond the number of workers fail.
+	 */
+	std::vector<PoolMessage> executeOnEach(std::vector<PoolMessage> &requests);
+
+	/**
+	 * Register a handler for a job type (before creating any pool).
+	 */
+	static bool registerJob(int type, JobHandler handler);
+
+private:
+	struct Worker {
+		int pid;
+		int input;	// to the worker
+		int output;	// from the worker
+	};
+
+	static std::map<int, JobHandler> &jobHandlers();
+	static void runJob(PoolMessage &request, PoolMessage &reply);
+	[[noreturn]] static void workerLoop(int input, int output);
+
+	bool spawnWorker();
+	void killWorker(size_t index);
+	void collectReplies(std::vector<PoolMessage> &requests, std::vector<PoolMessage> &replies,
+	                    bool fixedAssignment);
+
+	std::vector<std::pair<EasyTerm*, int>> rewriteBatch(JobType type,
+	                                                    const std::vector<EasyTerm*> &terms,
+	                                                    int bound, int gas);
+
+	std::vector<Worker> workers;
+};
+
+#endif // ENGINE_POOL_HH
@@ -4,6 +4,7 @@
  * Wraps some Maude high-level functions.
  */
 
+#include <chrono>
 #include <climits>
 #include <iostream>
 
@@ -25,6 +26,11 @@
 #include "metaLevelOpSymbol.hh"
 #include "randomOpSymbol.hh"
 #include "pigPug.hh"
+#include "memoryCell.hh"
+#include "statistics.hh"
+#include "easyTerm.hh"
+#include "trace_recorder.hh"
+#include "search_monitor.hh"
 
 // To retrieve the module path (dladdr, non-standard)
 #if defined(_WIN32)
@@ -157,6 +163,9 @@ init(bool readPrelude, int randomSeed, bool advise, bool handleInterrupts)
 
 	createRootBuffer(fp, false);
 	directoryManager.initialize();
+
+	// Start counting garbage collections
+	StatsRecorder::getGcCount();
 	ioManager.setAutoWrap(false);
 
 	// Take the path of the binary as a search directory
@@ -357,6 +366,56 @@ bool setAssocUnifDepth(float m) {
 	return false;
 }
 
+struct HackNodesInUse {
+	typedef int* type;
+	friend type get(HackNodesInUse);
+};
+
+template struct PrivateHack<HackNodesInUse, &MemoryCell::nrNodesInUse>;
+
+struct HackNrArenas {
+	typedef int* type;
+	friend type get(HackNrArenas);
+};
+
+template struct PrivateHack<HackNrArenas, &MemoryCell::nrArenas>;
+
+struct HackNeedToCollect {
+	typedef bool* type;
+	friend type get(HackNeedToCollect);
+};
+
+template struct PrivateHack<HackNeedToCollect, &MemoryCell::needToCollectGarbage>;
+
+static double gcForcedTime = 0.0;
+
+GcStats
+getGcStats() {
+	return {StatsRecorder::getGcCount(),
+		*get(HackNodesInUse()),
+		*get(HackNrArenas()),
+		gcForcedTime,
+		(long long) (RootPool<EasyTerm>::size() + RootPool<EasySubstitution>::size())};
+}
+
+void
+collectGarbage() {
+	auto start = chrono::steady_clock::now();
+
+	// Collections only happen when the allocator asks for them
+	*get(HackNeedToCollect()) = true;
+	MemoryCell::okToCollectGarbage();
+
+	gcForcedTime += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void
+refreshTraceStatus() {
+	UserLevelRewritingContext::setTraceStatus(interpreter.getFlag(Interpreter::EXCEPTION_FLAGS)
+		|| TraceRecorder::isRecording() || SearchMonitor::isMonitoring()
+		|| UserLevelRewritingContext::aborted());
+}
+
 MetaLevel*
 getMetaLevel(VisibleModule* vmod) {
 	// Finds an operator of type MetaLevelOpSymbol for which to obtain
@@ -185,6 +185,36 @@ void setRandomSeed(int seed);
  */
 bool setAssocUnifDepth(float m);
 
+/**
+ * Statistics of the garbage collector.
+ */
+struct GcStats {
+	long long collections;	///< Number of collections since initialization.
+	long long nodesInUse;	///< Number of live nodes after the last collection.
+	long long arenas;	///< Number of node arenas allocated.
+	double forcedTime;	///< Time in seconds spent in forced collections.
+	long long roots;	///< Number of terms and substitutions held by the bindings.
+};
+
+/**
+ * Get the statistics of the garbage collector.
+ */
+GcStats getGcStats();
+
+/**
+ * Run the garbage collector now.
+ */
+void collectGarbage();
+
+/**
+ * Enable the slow path of the rewriting contexts when it is required by
+ * the interpreter flags, a trace recorder, a search monitor or a pending
+ * abort, and disable it otherwise.
+ *
+ * @note For internal use.
+ */
+void refreshTraceStatus();
+
 /**
  * Data associated to a hook and passed to its callback.
  */
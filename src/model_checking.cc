@@ -21,6 +21,10 @@
 #include "temporalSymbol.hh"
 
 #include "maude_wrappers.hh"
+#include "statistical_checking.hh"
+
+#include <algorithm>
+#include <vector>
 
 //
 // TemporalSymbol is subclassed to give access to its protected methods
@@ -192,6 +196,27 @@ StrategySystemAutomaton::checkProposition(int stateNr, int propositionIndex) con
   return result;
 }
 
+struct TraceSystemAutomaton : public BaseSystemAutomaton
+{
+	int getNextState(int stateNr, int transitionNr);
+	bool checkProposition(int stateNr, int propositionIndex) const;
+
+	const std::vector<DagNode*>* trace;
+};
+
+int
+TraceSystemAutomaton::getNextState(int stateNr, int transitionNr) {
+	// The last state of the trace has a self loop
+	if (transitionNr > 0)
+		return NONE;
+	return std::min(stateNr + 1, int(trace->size()) - 1);
+}
+
+bool
+TraceSystemAutomaton::checkProposition(int stateNr, int propositionIndex) const {
+	return BaseSystemAutomaton::checkProposition((*trace)[stateNr], propositionIndex);
+}
+
 bool
 prepareModelChecker(BaseSystemAutomaton &system, RewritingContext* context, DagNode* termFormula, LogicFormula &formula, int &top) {
 	VisibleModule* mod = dynamic_cast<VisibleModule*>(context->root()->symbol()->getModule());
@@ -322,3 +347,74 @@ modelCheck(StrategyTransitionGraph &graph, DagNode* termFormula) {
 	else
 		return new ModelCheckResult{true, {}, {}, nrBuchiStates};
 }
+
+TraceFormula::TraceFormula(RewritingContext* context, DagNode* termFormula)
+ : system(new TraceSystemAutomaton), formula(new LogicFormula)
+{
+	valid = prepareModelChecker(*system, context, termFormula, *formula, top);
+}
+
+TraceFormula::~TraceFormula() {
+	delete formula;
+	delete system;
+}
+
+bool
+TraceFormula::check(const std::vector<DagNode*> &trace) {
+	int length = trace.size();
+	int nrNodes = formula->nrNodes();
+
+	system->trace = &trace;
+
+	// The negated formula is evaluated bottom-up (arguments are built
+	// before the formulae that contain them) and backwards along the
+	// trace, where the last state behaves as an infinite suffix
+	std::vector<std::vector<bool>> values(nrNodes, std::vector<bool>(length));
+
+	for (int node = 0; node < nrNodes; node++) {
+		std::vector<bool> &value = values[node];
+
+		for (int position = length - 1; position >= 0; position--) {
+			bool last = position == length - 1;
+
+			switch (formula->getOp(node)) {
+				case LogicFormula::PROPOSITION:
+					value[position] = system->checkProposition(position, formula->getPropIndex(node));
+					break;
+				case LogicFormula::LTL_TRUE:
+					value[position] = true;
+					break;
+				case LogicFormula::LTL_FALSE:
+					value[position] = false;
+					break;
+				case LogicFormula::NOT:
+					value[position] = !values[formula->getArg(node, 0)][position];
+					break;
+				case LogicFormula::NEXT:
+					value[position] = values[formula->getArg(node, 0)][last ? position : position + 1];
+					break;
+				case LogicFormula::AND:
+					value[position] = values[formula->getArg(node, 0)][position]
+						&& values[formula->getArg(node, 1)][position];
+					break;
+				case LogicFormula::OR:
+					value[position] = values[formula->getArg(node, 0)][position]
+						|| values[formula->getArg(node, 1)][position];
+					break;
+				case LogicFormula::UNTIL:
+					value[position] = values[formula->getArg(node, 1)][position]
+						|| (!last && values[formula->getArg(node, 0)][position] && value[position + 1]);
+					break;
+				case LogicFormula::RELEASE:
+					value[position] = values[formula->getArg(node, 1)][position]
+						&& (last || values[formula->getArg(node, 0)][position] || value[position + 1]);
+					break;
+				default:
+					break;
+			}
+		}
+	}
+
+	// The formula holds if its negation does not
+	return length == 0 || !values[top][0];
+}
@@ -0,0 +1,291 @@
+/**
+ * @file module_cache.cc
+ *
+ * Caches associated to modules.
+ */
+
+#include "module_cache.hh"
+
+#include "term.hh"
+#include "dagNode.hh"
+#include "strategyExpression.hh"
+#include "importTranslation.hh"
+
+using namespace std;
+
+map<VisibleModule*, ParseCache*> ParseCache::caches;
+
+ParseCache::ParseCache(VisibleModule* vmod, size_t capacity)
+ : vmod(vmod), capacity(capacity)
+{
+	vmod->addUser(this);
+	caches[vmod] = this;
+}
+
+ParseCache::~ParseCache() {
+	clear();
+}
+
+void
+ParseCache::regretToInform(Entity*) {
+	// The module is being deleted
+	caches.erase(vmod);
+	delete this;
+}
+
+ParseCache*
+ParseCache::find(VisibleModule* vmod) {
+	auto it = caches.find(vmod);
+	return it != caches.end() ? it->second : nullptr;
+}
+
+void
+ParseCache::setCapacity(VisibleModule* vmod, size_t capacity) {
+	ParseCache* cache = find(vmod);
+
+	if (cache == nullptr) {
+		if (capacity > 0)
+			new ParseCache(vmod, capacity);
+	}
+	else if (capacity == 0) {
+		vmod->removeUser(cache);
+		caches.erase(vmod);
+		delete cache;
+	}
+	else {
+		cache->capacity = capacity;
+		cache->shrink();
+	}
+}
+
+CacheStats
+ParseCache::getStats(VisibleModule* vmod) {
+	if (ParseCache* cache = find(vmod))
+		return {cache->hits, cache->misses, cache->evictions,
+			(long long) cache->entries.size(), (long long) cache->capacity};
+
+	return {0, 0, 0, 0, 0};
+}
+
+ParseCache::Key
+ParseCache::makeKey(const char* text, bool strategy, ConnectedComponent* kind,
+                    const MixfixModule::AliasMap &aliases) {
+	return {text, strategy, kind, {aliases.begin(), aliases.end()}};
+}
+
+void
+ParseCache::destroy(Value &value) {
+	if (Term** term = get_if<Term*>(&value))
+		(*term)->deepSelfDestruct();
+	else
+		delete get<StrategyExpression*>(value);
+}
+
+const ParseCache::Value*
+ParseCache::lookup(const Key &key) {
+	auto it = index.find(key);
+
+	if (it == index.end()) {
+		misses++;
+		return nullptr;
+	}
+
+	// Move the entry to the front
+	entries.splice(entries.begin(), entries, it->second);
+	hits++;
+
+	return &it->second->second;
+}
+
+void
+ParseCache::insert(Key &&key, Value value) {
+	auto it = index.find(key);
+
+	// The entry is already in the cache
+	if (it != index.end()) {
+		destroy(value);
+		return;
+	}
+
+	entries.emplace_front(std::move(key), value);
+	index.insert({entries.front().first, entries.begin()});
+	shrink();
+}
+
+void
+ParseCache::shrink() {
+	while (entries.size() > capacity) {
+		Entry &last = entries.back();
+		index.erase(last.first);
+		destroy(last.second);
+		entries.pop_back();
+		evictions++;
+	}
+}
+
+void
+ParseCache::clear() {
+	for (Entry &entry : entries)
+		destroy(entry.second);
+
+	entries.clear();
+	index.clear();
+}
+
+Term*
+ParseCache::getTerm(const char* text, ConnectedComponent* kind, const MixfixModule::AliasMap &aliases) {
+	const Value* value = lookup(makeKey(text, false, kind, aliases));
+	return value != nullptr ? get<Term*>(*value)->deepCopy() : nullptr;
+}
+
+StrategyExpression*
+ParseCache::getStrategy(const char* text, const MixfixModule::AliasMap &aliases) {
+	const Value* value = lookup(makeKey(text, true, nullptr, aliases));
+
+	if (value == nullptr)
+		return nullptr;
+
+	ImportTranslation translation(vmod);
+	return ImportModule::deepCopyStrategyExpression(&translation, get<StrategyExpression*>(*value));
+}
+
+void
+ParseCache::putTerm(const char* text, ConnectedComponent* kind, const MixfixModule::AliasMap &aliases, Term* term) {
+	insert(makeKey(text, false, kind, aliases), term->deepCopy());
+}
+
+void
+ParseCache::putStrategy(const char* text, const MixfixModule::AliasMap &aliases, StrategyExpression* expr) {
+	ImportTranslation translation(vmod);
+	insert(makeKey(text, true, nullptr, aliases), ImportModule::deepCopyStrategyExpression(&translation, expr));
+}
+
+//
+// Normal form cache
+//
+
+map<VisibleModule*, NormalFormCache*> NormalFormCache::caches;
+
+NormalFormCache::NormalFormCache(VisibleModule* vmod, size_t maxEntries)
+ : vmod(vmod), maxEntries(maxEntries)
+{
+	vmod->addUser(this);
+	caches[vmod] = this;
+	link();
+}
+
+NormalFormCache::~NormalFormCache() {
+	unlink();
+}
+
+void
+NormalFormCache::regretToInform(Entity*) {
+	// The module is being deleted
+	caches.erase(vmod);
+	delete this;
+}
+
+void
+NormalFormCache::markReachableNodes() {
+	for (Entry &entry : entries) {
+		entry.dagNode->mark();
+		entry.normalForm->mark();
+	}
+}
+
+NormalFormCache*
+NormalFormCache::find(VisibleModule* vmod) {
+	auto it = caches.find(vmod);
+	return it != caches.end() ? it->second : nullptr;
+}
+
+void
+NormalFormCache::setMaxEntries(VisibleModule* vmod, size_t maxEntries) {
+	NormalFormCache* cache = find(vmod);
+
+	if (cache == nullptr) {
+		if (maxEntries > 0)
+			new NormalFormCache(vmod, maxEntries);
+	}
+	else if (maxEntries == 0) {
+		vmod->removeUser(cache);
+		caches.erase(vmod);
+		delete cache;
+	}
+	else {
+		cache->maxEntries = maxEntries;
+		cache->shrink();
+	}
+}
+
+CacheStats
+NormalFormCache::getStats(VisibleModule* vmod) {
+	if (NormalFormCache* cache = find(vmod))
+		return {cache->hits, cache->misses, cache->evictions,
+			(long long) cache->entries.size(), (long long) cache->maxEntries};
+
+	return {0, 0, 0, 0, 0};
+}
+
+list<NormalFormCache::Entry>::iterator
+NormalFormCache::lookup(DagNode* dagNode, size_t hash) {
+	auto [begin, end] = index.equal_range(hash);
+
+	for (auto it = begin; it != end; ++it)
+		if (it->second->dagNode->equal(dagNode))
+			return it->second;
+
+	return entries.end();
+}
+
+DagNode*
+NormalFormCache::get(DagNode* dagNode) {
+	auto it = lookup(dagNode, dagNode->getHashValue());
+
+	if (it == entries.end()) {
+		misses++;
+		return nullptr;
+	}
+
+	// Move the entry to the front
+	entries.splice(entries.begin(), entries, it);
+	hits++;
+
+	return it->normalForm;
+}
+
+void
+NormalFormCache::put(DagNode* dagNode, DagNode* normalForm) {
+	size_t hash = dagNode->getHashValue();
+
+	// The entry is already in the cache
+	if (lookup(dagNode, hash) != entries.end())
+		return;
+
+	entries.push_front({dagNode, normalForm, hash});
+	index.insert({hash, entries.begin()});
+	shrink();
+}
+
+void
+NormalFormCache::shrink() {
+	while (entries.size() > maxEntries) {
+		Entry &last = entries.back();
+		auto [begin, end] = index.equal_range(last.hash);
+
+		for (auto it = begin; it != end; ++it)
+			if (&*it->second == &last) {
+				index.erase(it);
+				break;
+			}
+
+		entries.pop_back();
+		evictions++;
+	}
+}
+
+void
+NormalFormCache::clear() {
+	entries.clear();
+	index.clear();
+}
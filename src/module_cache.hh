@@ -0,0 +1,201 @@
+/**
+ * @file module_cache.hh
+ *
+ * Caches associated to modules.
+ */
+
+#ifndef MODULE_CACHE_HH
+#define MODULE_CACHE_HH
+
+#include "macros.hh"
+#include "vector.hh"
+#include "core.hh"
+#include "interface.hh"
+#include "mixfix.hh"
+#include "higher.hh"
+#include "strategyLanguage.hh"
+
+#include "entity.hh"
+#include "visibleModule.hh"
+#include "rootContainer.hh"
+
+#include <list>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+/**
+ * Statistics of a cache.
+ */
+struct CacheStats {
+	long long hits;		///< Number of successful lookups.
+	long long misses;	///< Number of failed lookups.
+	long long evictions;	///< Number of entries removed to make room for others.
+	long long size;		///< Current number of entries.
+	long long capacity;	///< Maximum number of entries.
+};
+
+/**
+ * Bounded LRU cache of parsed terms and strategies for a module.
+ *
+ * Caches are registered as users of their modules and they are
+ * deleted when the module is.
+ */
+class ParseCache : private Entity::User {
+public:
+	/**
+	 * Get the parse cache of a module.
+	 *
+	 * @return The cache or null if caching is disabled for the module.
+	 */
+	static ParseCache* find(VisibleModule* vmod);
+
+	/**
+	 * Set the capacity of the parse cache of a module (@c 0 disables it).
+	 */
+	static void setCapacity(VisibleModule* vmod, size_t capacity);
+
+	/**
+	 * Get the statistics of the parse cache of a module.
+	 */
+	static CacheStats getStats(VisibleModule* vmod);
+
+	/**
+	 * Get a copy of a cached term or null if not found.
+	 */
+	Term* getTerm(const char* text, ConnectedComponent* kind, const MixfixModule::AliasMap &aliases);
+
+	/**
+	 * Get a copy of a cached strategy expression or null if not found.
+	 */
+	StrategyExpression* getStrategy(const char* text, const MixfixModule::AliasMap &aliases);
+
+	/**
+	 * Insert a copy of a parsed term into the cache.
+	 */
+	void putTerm(const char* text, ConnectedComponent* kind, const MixfixModule::AliasMap &aliases, Term* term);
+
+	/**
+	 * Insert a copy of a parsed strategy expression into the cache.
+	 */
+	void putStrategy(const char* text, const MixfixModule::AliasMap &aliases, StrategyExpression* expr);
+
+	/**
+	 * Remove all entries from the cache.
+	 */
+	void clear();
+
+private:
+	// Text, whether it is a strategy, kind, and variable aliases
+	using Key = std::tuple<std::string, bool, ConnectedComponent*, std::vector<std::pair<int, Sort*>>>;
+	using Value = std::variant<Term*, StrategyExpression*>;
+	using Entry = std::pair<Key, Value>;
+
+	ParseCache(VisibleModule* vmod, size_t capacity);
+	~ParseCache();
+
+	void regretToInform(Entity* doomedEntity);
+
+	static Key makeKey(const char* text, bool strategy, ConnectedComponent* kind,
+	                   const MixfixModule::AliasMap &aliases);
+	static void destroy(Value &value);
+
+	const Value* lookup(const Key &key);
+	void insert(Key &&key, Value value);
+	void shrink();
+
+	VisibleModule* vmod;
+	size_t capacity;
+
+	// Entries in order of use (most recent first)
+	std::list<Entry> entries;
+	std::map<Key, std::list<Entry>::iterator> index;
+
+	long long hits = 0;
+	long long misses = 0;
+	long long evictions = 0;
+
+	static std::map<VisibleModule*, ParseCache*> caches;
+};
+
+/**
+ * LRU cache of the normal forms of ground terms for a module with a limit
+ * on its number of entries, consulted by reduce before reducing.
+ *
+ * Cached normal forms are only valid if reduction is deterministic, so
+ * the cache should not be enabled in modules with operators whose result
+ * may change between calls (like random numbers or external objects).
+ */
+class NormalFormCache : private RootContainer, private Entity::User {
+public:
+	/**
+	 * Get the normal form cache of a module.
+	 *
+	 * @return The cache or null if caching is disabled for the module.
+	 */
+	static NormalFormCache* find(VisibleModule* vmod);
+
+	/**
+	 * Set the maximum number of entries of the normal form cache of a
+	 * module (@c 0 disables it), regardless of the size of their terms.
+	 */
+	static void setMaxEntries(VisibleModule* vmod, size_t maxEntries);
+
+	/**
+	 * Get the statistics of the normal form cache of a module.
+	 */
+	static CacheStats getStats(VisibleModule* vmod);
+
+	/**
+	 * Get the cached normal form of a term or null if not found.
+	 */
+	DagNode* get(DagNode* dagNode);
+
+	/**
+	 * Insert the normal form of a term into the cache.
+	 *
+	 * @param dagNode The term before reduction (it should not be
+	 * reduced in place afterwards).
+	 * @param normalForm Its normal form.
+	 */
+	void put(DagNode* dagNode, DagNode* normalForm);
+
+	/**
+	 * Remove all entries from the cache.
+	 */
+	void clear();
+
+private:
+	struct Entry {
+		DagNode* dagNode;
+		DagNode* normalForm;
+		size_t hash;
+	};
+
+	NormalFormCache(VisibleModule* vmod, size_t maxEntries);
+	~NormalFormCache();
+
+	void regretToInform(Entity* doomedEntity);
+	void markReachableNodes();
+
+	std::list<Entry>::iterator lookup(DagNode* dagNode, size_t hash);
+	void shrink();
+
+	VisibleModule* vmod;
+	size_t maxEntries;
+
+	// Entries in order of use (most recent first)
+	std::list<Entry> entries;
+	std::unordered_multimap<size_t, std::list<Entry>::iterator> index;
+
+	long long hits = 0;
+	long long misses = 0;
+	long long evictions = 0;
+
+	static std::map<VisibleModule*, NormalFormCache*> caches;
+};
+
+#endif // MODULE_CACHE_HH
@@ -0,0 +1,510 @@
+/**
+ * @file parallel_search.cc
+ *
+ * Breadth-first search distributed among the workers of an engine pool.
+ */
+
+#include "macros.hh"
+#include "core.hh"
+#include "interface.hh"
+#include "mixfix.hh"
+#include "higher.hh"
+
+#include "visibleModule.hh"
+#include "userLevelRewritingContext.hh"
+#include "rewriteSearchState.hh"
+#include "matchSearchState.hh"
+#include "pattern.hh"
+
+#include "parallel_search.hh"
+#include "trace_recorder.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <unordered_set>
+
+using namespace std;
+
+//
+// Worker side
+//
+
+namespace {
+
+/**
+ * Partition of a parallel search owned by a worker.
+ */
+struct Partition {
+	Partition(VisibleModule* vmod, Pattern* pattern, SearchType type, int maxDepth,
+	          StateStorage storage, int log2Size, const string &directory)
+	 : vmod(vmod), visited(vmod, storage, log2Size, directory), pattern(pattern),
+	   type(type), maxDepth(maxDepth) {}
+
+	~Partition() { delete pattern; }
+
+	VisibleModule* vmod;
+	VisitedSet visited;
+	Pattern* pattern;
+	SearchType type;
+	int maxDepth;
+};
+
+map<long long, unique_ptr<Partition>> partitions;
+
+bool
+matchesPattern(DagNode* dag, Pattern* pattern) {
+	MatchSearchState state(new UserLevelRewritingContext(dag), pattern,
+	                       MatchSearchState::GC_CONTEXT);
+	return state.findNextMatch();
+}
+
+/**
+ * Write the successors of a state (preceded by their hash values) to
+ * the reply if required, unless they have already been written in the
+ * same step.
+ *
+ * @return The number of successors.
+ */
+int
+expandState(DagNode* dag, bool forward, PoolMessage &reply, unordered_set<string> &written,
+            long long &nrRewrites) {
+	UserLevelRewritingContext* context = new UserLevelRewritingContext(dag);
+	RewriteSearchState state(context, UNDEFINED,
+	                         RewriteSearchState::GC_CONTEXT | PositionState::RESPECT_FROZEN,
+	                         0, UNBOUNDED);
+	int nrSuccessors = 0;
+
+	while (state.findNextRewrite()) {
+		nrSuccessors++;
+
+		if (!forward)
+			break;
+
+		DagNode* replacement = state.rebuildDag(state.getReplacement()).first;
+		context->incrementRlCount();
+
+		RewritingContext* subcontext = context->makeSubcontext(replacement);
+		subcontext->reduce();
+		context->addInCount(*subcontext);
+
+		// Equal successors are detected by their serialization, which
+		// may only miss those whose DAGs share subterms differently
+		EasyTerm successor(subcontext->root());
+		string data = successor.serialize();
+
+		if (written.insert(data).second) {
+			reply.putInt(1);
+			reply.putInt(subcontext->root()->getHashValue());
+			reply.putString(data);
+		}
+
+		delete subcontext;
+	}
+
+	nrRewrites += context->getTotalCount();
+	return nrSuccessors;
+}
+
+bool
+startJob(PoolMessage &request, PoolMessage &) {
+	long long searchId = request.getInt();
+	EasyTerm* target = request.getTerm();
+
+	if (target == nullptr)
+		return false;
+
+	SearchType type = SearchType(request.getInt());
+	int maxDepth = request.getInt();
+	StateStorage storage = StateStorage(request.getInt());
+	int log2Size = request.getInt();
+	string directory = request.getString();
+
+	VisibleModule* vmod = safeCast(VisibleModule*, target->symbol()->getModule());
+	Vector<ConditionFragment*> condition;
+	Pattern* pattern = new Pattern(target->termCopy(), false, condition);
+	delete target;
+
+	partitions[searchId] = make_unique<Partition>(vmod, pattern, type, maxDepth,
+	                                              storage, log2Size, directory);
+	return true;
+}
+
+bool
+stepJob(PoolMessage &request, PoolMessage &reply) {
+	auto it = partitions.find(request.getInt());
+
+	if (it == partitions.end())
+		return false;
+
+	Partition &partition = *it->second;
+	VisibleModule* vmod = partition.vmod;
+	int depth = request.getInt();
+	long long nrStates = request.getInt();
+
+	// Whether the successors of the states in this level are explored
+	bool forward = (partition.maxDepth < 0 || depth < partition.maxDepth)
+		&& (partition.type != ONE_STEP || depth == 0);
+	bool solutionLevel = partition.type == ANY_STEPS
+		|| (partition.type == AT_LEAST_ONE_STEP && depth > 0)
+		|| (partition.type == ONE_STEP && depth == 1);
+
+	// The states are read in advance, so that the module is set up once
+	// and they are all reduced in place with a shared context (the terms
+	// keep the reduced DAGs reachable while they are expanded)
+	vector<unique_ptr<EasyTerm>> states;
+
+	for (long long i = 0; i < nrStates; i++) {
+		states.emplace_back(request.getTerm(vmod));
+
+		if (states.back() == nullptr)
+			return false;
+	}
+
+	long long nrNewStates = 0, nrRewrites = 0;
+	PoolMessage solutions, successors;
+	unordered_set<string> written;
+	bool completed = true;
+
+	if (!states.empty()) {
+		RecordingRewritingContext context(states[0]->getDag());
+		EasyTerm::startUsingModule(vmod);
+
+		for (unique_ptr<EasyTerm> &state : states) {
+			DagNode* dag = state->getDag();
+			context.clearCount();
+			dag->reduce(context);
+			nrRewrites += context.getTotalCount();
+
+			if (UserLevelRewritingContext::aborted()) {
+				completed = false;
+				break;
+			}
+
+			if (!partition.visited.insert(dag)) {
+				if (partition.visited.hasFailed()) {
+					completed = false;
+					break;
+				}
+				continue;
+			}
+
+			nrNewStates++;
+
+			int nrSuccessors = 0;
+
+			// Normal forms are checked even beyond the depth bound
+			if (forward || partition.type == NORMAL_FORM)
+				nrSuccessors = expandState(dag, forward, successors, written, nrRewrites);
+
+			if ((solutionLevel || (partition.type == NORMAL_FORM && nrSuccessors == 0))
+			    && matchesPattern(dag, partition.pattern)) {
+				EasyTerm solution(dag);
+				solutions.putInt(1);
+				solutions.putString(solution.serialize());
+			}
+
+			if (UserLevelRewritingContext::aborted()) {
+				completed = false;
+				break;
+			}
+		}
+
+		(void) vmod->unprotect();
+	}
+
+	if (!completed)
+		return false;
+
+	solutions.putInt(0);
+	successors.putInt(0);
+
+	reply.putInt(nrNewStates);
+	reply.putInt(nrRewrites);
+	reply.putDouble(partition.visited.getLogNoOmission());
+	reply.putInt(partition.visited.getByteSize());
+	reply.putString(solutions.data());
+	reply.putString(successors.data());
+
+	return true;
+}
+
+bool
+endJob(PoolMessage &request, PoolMessage &) {
+	return partitions.erase(request.getInt()) > 0;
+}
+
+[[maybe_unused]] bool parallelSearchJobsRegistered =
+	EnginePool::registerJob(EnginePool::PSEARCH_START_JOB, startJob) &&
+	EnginePool::registerJob(EnginePool::PSEARCH_STEP_JOB, stepJob) &&
+	EnginePool::registerJob(EnginePool::PSEARCH_END_JOB, endJob);
+
+}
+
+//
+// Parent side
+//
+
+ParallelSearch::ParallelSearch(EnginePool* pool, EasyTerm* initial, SearchType type,
+                               EasyTerm* target, int depth)
+ : pool(pool),
+   vmod(safeCast(VisibleModule*, initial->symbol()->getModule())),
+   maxDepth(depth),
+   type(type)
+{
+	static long long lastSearchId = 0;
+	searchId = ++lastSearchId;
+	nrWorkers = pool->getNrWorkers();
+	nrPartitions = max(1, nrWorkers);
+
+	// Solutions may be read after the exploration has finished
+	vmod->protect();
+
+	if (type == BRANCH) {
+		IssueWarning("branching search is not supported in parallel.");
+		return;
+	}
+
+	if (target->symbol()->getModule() != vmod) {
+		IssueWarning("the pattern does not belong to the module of the initial term.");
+		return;
+	}
+
+	this->target = target->serialize();
+
+	// The initial state is reduced here to find its owner
+	EasyTerm* initialCopy = initial->copy();
+	nrRewrites += initialCopy->reduce();
+	initialState = initialCopy->serialize();
+	initialOwner = initialCopy->hash() % nrPartitions;
+	delete initialCopy;
+
+	running = true;
+}
+
+ParallelSearch::~ParallelSearch() {
+	finish();
+	(void) vmod->unprotect();
+}
+
+bool
+ParallelSearch::setStateStorage(StateStorage storage, int log2Size, const string &directory) {
+	if (started) {
+		IssueWarning("the storage of the states cannot be changed once the search has started.");
+		return false;
+	}
+
+	this->storage = storage;
+	this->log2Size = log2Size;
+	this->directory = directory;
+	return true;
+}
+
+double
+ParallelSearch::getOmissionProbability() const {
+	double logSum = 0.0;
+
+	for (double value : logNoOmission)
+		logSum += value;
+
+	return -expm1(logSum);
+}
+
+bool
+ParallelSearch::start() {
+	// Every partition is started with the pattern
+	vector<PoolMessage> requests(nrPartitions);
+
+	for (PoolMessage &request : requests) {
+		request.putInt(EnginePool::PSEARCH_START_JOB);
+		request.putInt(searchId);
+		request.putString(target);
+		request.putInt(type);
+		request.putInt(maxDepth);
+		request.putInt(storage);
+		request.putInt(log2Size);
+		request.putString(directory);
+	}
+
+	started = true;
+	logNoOmission.assign(nrPartitions, 0.0);
+	visitedBytes.assign(nrPartitions, 0);
+
+	// The frontier is also kept on disk with disk storage
+	for (int i = 0; i < nrPartitions; i++) {
+		frontier.emplace_back(storage == DISK_STATES, directory);
+		nextFrontier.emplace_back(storage == DISK_STATES, directory);
+	}
+
+	frontier[initialOwner].append(initialState);
+
+	for (PoolMessage &reply : pool->executeOnEach(requests))
+		if (reply.getInt() != EnginePool::JOB_SUCCEEDED) {
+			fail();
+			return false;
+		}
+
+	return true;
+}
+
+void
+ParallelSearch::fail() {
+	IssueWarning("the parallel search has been interrupted.");
+	finish();
+}
+
+void
+ParallelSearch::finish() {
+	if (!running)
+		return;
+
+	running = false;
+	frontier.clear();
+	nextFrontier.clear();
+
+	// Partitions are discarded by the workers that are still alive
+	if (started && pool->getNrWorkers() == nrWorkers) {
+		vector<PoolMessage> requests(nrPartitions);
+
+		for (PoolMessage &request : requests) {
+			request.putInt(EnginePool::PSEARCH_END_JOB);
+			request.putInt(searchId);
+		}
+
+		pool->executeOnEach(requests);
+	}
+}
+
+bool
+ParallelSearch::expandLevel() {
+	if (!running || (!started && !start()))
+		return false;
+	// The search ends when no state remains to be explored
+	bool empty = true;
+
+	for (const StateStore &states : frontier)
+		empty = empty && states.size() == 0;
+
+	if (empty) {
+		finish();
+		return false;
+	}
+
+	// Workers must not have changed since the search started
+	if (pool->getNrWorkers() != nrWorkers) {
+		fail();
+		return false;
+	}
+
+	// The frontier is sent in bounded chunks and the successors are
+	// stored in the next frontier as they arrive, so that neither the
+	// parent nor the workers hold a whole level in memory
+	vector<size_t> nrSentBy(nrPartitions, 0);
+	long long nrSent = 0, nrNewStates = 0;
+	bool pending = true;
+
+	while (pending) {
+		vector<PoolMessage> requests(nrPartitions);
+		pending = false;
+
+		for (int i = 0; i < nrPartitions; i++) {
+			size_t first = nrSentBy[i];
+			size_t last = min(frontier[i].size(), first + STATES_PER_STEP);
+
+			requests[i].putInt(EnginePool::PSEARCH_STEP_JOB);
+			requests[i].putInt(searchId);
+			requests[i].putInt(depth);
+			requests[i].putInt(last - first);
+
+			for (size_t j = first; j < last; j++)
+				requests[i].putString(frontier[i].get(j));
+
+			nrSentBy[i] = last;
+			nrSent += last - first;
+			pending = pending || last < frontier[i].size();
+		}
+
+		vector<PoolMessage> replies = pool->executeOnEach(requests);
+
+		for (int i = 0; i < nrPartitions; i++) {
+			PoolMessage &reply = replies[i];
+
+			if (reply.getInt() != EnginePool::JOB_SUCCEEDED) {
+				fail();
+				return false;
+			}
+
+			nrNewStates += reply.getInt();
+			nrRewrites += reply.getInt();
+			logNoOmission[i] = reply.getDouble();
+			visitedBytes[i] = reply.getInt();
+
+			PoolMessage levelSolutions(reply.getString());
+
+			while (levelSolutions.getInt() != 0)
+				solutions.push_back(levelSolutions.getString());
+
+			// Successors are routed to their owners without being deserialized
+			PoolMessage successors(reply.getString());
+
+			while (successors.getInt() != 0) {
+				size_t hash = successors.getInt();
+				if (nextFrontier[hash % nrPartitions].append(successors.getString()) == size_t(NONE)) {
+					fail();
+					return false;
+				}
+			}
+		}
+	}
+
+	frontier.swap(nextFrontier);
+
+	for (StateStore &states : nextFrontier)
+		states.clear();
+
+	// States already visited in their partitions are duplicates
+	nrStates += nrNewStates;
+	nrDuplicates += nrSent - nrNewStates;
+	depth++;
+
+	monitor.check();
+	return true;
+}
+
+EasyTerm*
+ParallelSearch::next() {
+	// The callback is checked by the search between levels
+	SearchMonitor::Scope scope(&monitor, false);
+
+	while (solutions.empty())
+		if (!expandLevel())
+			return nullptr;
+
+	EasyTerm* solution = EasyTerm::deserialize(vmod, solutions.front());
+	solutions.pop_front();
+	return solution;
+}
+
+long long
+ParallelSearch::Monitor::countStates() const {
+	return search->nrStates;
+}
+
+void
+ParallelSearch::Monitor::sample(SearchProgress &progress) const {
+	progress.nrStates = search->nrStates;
+	progress.nrDuplicates = search->nrDuplicates;
+	progress.depth = search->depth;
+	progress.rewrites = search->nrRewrites;
+	progress.frontierSize = 0;
+	progress.storageBytes = 0;
+
+	for (const StateStore &states : search->frontier) {
+		progress.frontierSize += states.size();
+		progress.storageBytes += states.getByteSize();
+	}
+
+	for (long long bytes : search->visitedBytes)
+		progress.storageBytes += bytes;
+}
@@ -0,0 +1,223 @@
+/**
+ * @file parallel_search.hh
+ *
+ * Breadth-first search distributed among the workers of an engine pool.
+ */
+
+#ifndef PARALLEL_SEARCH_HH
+#define PARALLEL_SEARCH_HH
+
+#include "engine_pool.hh"
+#include "visited_set.hh"
+#include "state_store.hh"
+#include "search_monitor.hh"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+/**
+ * Breadth-first search whose state space is partitioned among the
+ * workers of an engine pool by the hash value of the states.
+ *
+ * Each worker owns the visited states of its partition and expands
+ * the states of the current level that belong to it. States are sent to
+ * the workers and their successors are routed to their owners through the
+ * parent process in serialized form in chunks of bounded size, and the
+ * successors are only expanded in the next level.
+ * Only rules are applied (no strategies) and the pattern cannot have a
+ * condition. Solutions are reported in the order of their levels, but
+ * not necessarily in the order of the sequential search.
+ *
+ * The exploration starts when the first solution is requested, so its
+ * options can be set before.
+ */
+class ParallelSearch {
+public:
+	/**
+	 * Start a parallel search.
+	 *
+	 * @param pool Engine pool (that must outlive the search).
+	 * @param initial Initial term (it is not modified).
+	 * @param type Type of search (@c BRANCH is not supported).
+	 * @param target Pattern term.
+	 * @param depth Depth bound (@c -1 for no bound).
+	 */
+	ParallelSearch(EnginePool* pool, EasyTerm* initial, SearchType type,
+	               EasyTerm* target, int depth = -1);
+	~ParallelSearch();
+
+	/**
+	 * Set how the visited states are stored in each partition
+	 * (before the exploration starts).
+	 *
+	 * @param storage Storage mode.
+	 * @param log2Size Base-2 logarithm of the number of bits of the
+	 * array of each partition for @c BITSTATE_HASHING (@c 27 by default),
+	 * or of the number of states cached in memory by each partition for
+	 * @c DISK_STATES (@c 16 by default), where negative means the default.
+	 * @param directory Directory of the state files for @c DISK_STATES
+	 * (the temporary directory of the system if empty).
+	 *
+	 * @return Whether the mode has been set.
+	 */
+	bool setStateStorage(StateStorage storage, int log2Size = -1,
+	                     const std::string &directory = "");
+
+	/**
+	 * Get the estimated probability that some state has been omitted
+	 * due to the compaction of the visited states.
+	 */
+	double getOmissionProbability() const;
+
+	/**
+	 * Whether the exploration is still in progress (it has not
+	 * finished or failed).
+	 */
+	bool isRunning() const;
+
+	/**
+	 * Get the next solution.
+	 *
+	 * @return That solution or null if the end has been reached.
+	 */
+	EasyTerm* next();
+
+	/**
+	 * Get the total number of rewrites in all partitions.
+	 */
+	long long getRewriteCount() const;
+
+	/**
+	 * Get the number of distinct states visited in all partitions.
+	 */
+	long long getNrStates() const;
+
+	/**
+	 * Get the depth of the next level to be explored.
+	 */
+	int getDepth() const;
+
+	/**
+	 * Get the number of partitions of the state space.
+	 */
+	int getNrPartitions() const;
+
+	/**
+	 * Get the current progress of the search.
+	 */
+	SearchProgress getProgress() const;
+
+	/**
+	 * Set a callback for the progress of the search, which is checked
+	 * after every level.
+	 *
+	 * @param callback Callback object or null to remove the current one.
+	 * @param everyStates Number of new states between calls (non-positive
+	 * to disable this criterion).
+	 * @param everyMillis Milliseconds between calls (non-positive to
+	 * disable this criterion).
+	 */
+	void setProgressCallback(ProgressCallback* callback, long long everyStates = 0,
+	                         double everyMillis = 1000);
+
+private:
+	/**
+	 * Monitor of the progress of the search.
+	 */
+	class Monitor : public SearchMonitor {
+	public:
+		Monitor(const ParallelSearch* search) : search(search) {}
+
+	protected:
+		long long countStates() const override;
+		void sample(SearchProgress &progress) const override;
+
+	private:
+		const ParallelSearch* search;
+	};
+
+	/**
+	 * Expand the current level (if not empty).
+	 *
+	 * @return Whether the level has been expanded.
+	 */
+	bool expandLevel();
+	bool start();
+	void fail();
+	void finish();
+
+	EnginePool* pool;
+	VisibleModule* vmod;
+	long long searchId;
+	int nrWorkers;
+	int nrPartitions;
+	int maxDepth;
+	int depth = 0;
+	bool running = false;
+	bool started = false;
+
+	SearchType type;
+	std::string target;
+	StateStorage storage = FULL_STATES;
+	int log2Size = -1;
+	std::string directory;
+	std::string initialState;
+	int initialOwner = 0;
+
+	// Maximum number of states sent to a partition in a step job
+	static constexpr size_t STATES_PER_STEP = 1024;
+
+	// States of the current and the next level by partition (serialized)
+	std::vector<StateStore> frontier;
+	std::vector<StateStore> nextFrontier;
+	std::deque<std::string> solutions;
+
+	long long nrRewrites = 0;
+	long long nrStates = 0;
+	long long nrDuplicates = 0;
+	// Bytes of the compacted or disk storage by partition
+	std::vector<long long> visitedBytes;
+	// Logarithm of the probability of no omission by partition
+	std::vector<double> logNoOmission;
+
+	Monitor monitor{this};
+};
+
+inline bool
+ParallelSearch::isRunning() const {
+	return running;
+}
+
+inline long long
+ParallelSearch::getRewriteCount() const {
+	return nrRewrites;
+}
+
+inline long long
+ParallelSearch::getNrStates() const {
+	return nrStates;
+}
+
+inline int
+ParallelSearch::getDepth() const {
+	return depth;
+}
+
+inline int
+ParallelSearch::getNrPartitions() const {
+	return nrPartitions;
+}
+
+inline SearchProgress
+ParallelSearch::getProgress() const {
+	return monitor.getProgress();
+}
+
+inline void
+ParallelSearch::setProgressCallback(ProgressCallback* callback, long long everyStates,
+                                    double everyMillis) {
+	monitor.setCallback(callback, everyStates, everyMillis);
+}
+
+#endif // PARALLEL_SEARCH_HH
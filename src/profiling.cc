@@ -0,0 +1,103 @@
+/**
+ * @file profiling.cc
+ *
+ * Access to the statement profiler of Maude.
+ */
+
+#include "profiling.hh"
+#include "trace_recorder.hh"
+#include "search_monitor.hh"
+#include "maude_wrappers.hh"
+
+#include "macros.hh"
+#include "vector.hh"
+#include "core.hh"
+#include "interface.hh"
+#include "mixfix.hh"
+#include "higher.hh"
+#include "strategyLanguage.hh"
+#include "equation.hh"
+#include "rule.hh"
+#include "sortConstraint.hh"
+#include "strategyDefinition.hh"
+#include "profileModule.hh"
+#include "visibleModule.hh"
+#include "userLevelRewritingContext.hh"
+#include "interpreter.hh"
+#include "global.hh"
+
+using namespace std;
+
+//
+// The profiling counters are private attributes of ProfileModule
+// without public observers (other than showProfile), so they are
+// accessed with the same hack used in maude_wrappers.cc. The types of
+// the counters are private too, hence they are deduced.
+//
+
+template<typename Tag, auto M>
+struct ProfileHack {
+	friend auto get(Tag) {
+		return M;
+	}
+};
+
+#define PROFILE_HACK(tag, member) \
+	struct tag { friend auto get(tag); }; \
+	template struct ProfileHack<tag, &ProfileModule::member>;
+
+PROFILE_HACK(HackMbInfo, mbInfo)
+PROFILE_HACK(HackEqInfo, eqInfo)
+PROFILE_HACK(HackRlInfo, rlInfo)
+PROFILE_HACK(HackSdInfo, sdInfo)
+
+#undef PROFILE_HACK
+
+void
+setProfiling(bool flag, bool clearEachCall) {
+	interpreter.setFlag(Interpreter::PROFILE, flag);
+	interpreter.setFlag(Interpreter::AUTO_CLEAR_PROFILE, clearEachCall);
+	// Profiling is done in the slow path of the rewriting context
+	refreshTraceStatus();
+}
+
+template<typename StatementInfo>
+static StatementStats
+makeStats(const StatementInfo &info, int index) {
+	StatementStats stats = {0, 0, {}, {}};
+
+	// Counters are only allocated when statements are profiled
+	if (index < 0 || index >= info.length())
+		return stats;
+
+	const auto &profile = info[index];
+
+	stats.rewrites = profile.nrRewrites;
+	stats.conditionStarts = profile.nrConditionStarts;
+
+	for (int i = 0; i < profile.fragmentInfo.length(); i++) {
+		stats.fragmentSuccesses.push_back(profile.fragmentInfo[i].nrSuccesses);
+		stats.fragmentFailures.push_back(profile.fragmentInfo[i].nrFailures);
+	}
+
+	return stats;
+}
+
+StatementStats
+getStatementStats(VisibleModule* vmod, PreEquation* statement) {
+	int index = statement->getIndexWithinModule();
+
+	if (statement->getModule() != vmod)
+		return {0, 0, {}, {}};
+
+	if (dynamic_cast<Equation*>(statement))
+		return makeStats(vmod->*get(HackEqInfo()), index);
+	if (dynamic_cast<Rule*>(statement))
+		return makeStats(vmod->*get(HackRlInfo()), index);
+	if (dynamic_cast<SortConstraint*>(statement))
+		return makeStats(vmod->*get(HackMbInfo()), index);
+	if (dynamic_cast<StrategyDefinition*>(statement))
+		return makeStats(vmod->*get(HackSdInfo()), index);
+
+	return {0, 0, {}, {}};
+}
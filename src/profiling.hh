@@ -0,0 +1,40 @@
+/**
+ * @file profiling.hh
+ *
+ * Access to the statement profiler of Maude.
+ */
+
+#ifndef PROFILING_HH
+#define PROFILING_HH
+
+#include <vector>
+
+class VisibleModule;
+class PreEquation;
+
+/**
+ * Profile of a statement (equation, rule, membership axiom or
+ * strategy definition).
+ */
+struct StatementStats {
+	long long rewrites;			///< Number of times the statement has been applied.
+	long long conditionStarts;		///< Number of matches that started the evaluation of the condition.
+	std::vector<long long> fragmentSuccesses;	///< Number of successes of each condition fragment.
+	std::vector<long long> fragmentFailures;	///< Number of failures of each condition fragment.
+};
+
+/**
+ * Enable or disable the profiler.
+ *
+ * @param flag Whether profiling is enabled.
+ * @param clearEachCall Whether the profile of a module is cleared
+ * at the beginning of each operation on it.
+ */
+void setProfiling(bool flag, bool clearEachCall = true);
+
+/**
+ * Get the profile of a statement in a module.
+ */
+StatementStats getStatementStats(VisibleModule* vmod, PreEquation* statement);
+
+#endif // PROFILING_HH
@@ -0,0 +1,84 @@
+/**
+ * @file rewriter.cc
+ *
+ * Resumable rewriting sessions.
+ */
+
+#include "rewriter.hh"
+#include "trace_recorder.hh"
+
+#include "dagNode.hh"
+#include "userLevelRewritingContext.hh"
+#include "visibleModule.hh"
+#include "interpreter.hh"
+#include "global.hh"
+
+using namespace std;
+
+EasyRewriter::EasyRewriter(EasyTerm* term, Mode mode, int gas)
+ : mode(mode), gas(gas)
+{
+	vmod = dynamic_cast<VisibleModule*>(term->symbol()->getModule());
+
+	// Unreduced nodes are overwritten in place by the
+	// reduction, so the given term is copied
+	DagNode* dagNode = term->getDag();
+	if (!dagNode->isReduced())
+		dagNode = dagNode->copyAll();
+
+	context = new RecordingRewritingContext(dagNode);
+
+	if (mode == FREWRITE)
+		context->setObjectMode(ObjectSystemRewritingContext::FAIR);
+
+	// Rule scheduling is reset only when the session starts,
+	// so that it resumes between steps
+	if (interpreter.getFlag(Interpreter::AUTO_CLEAR_RULES))
+		vmod->resetRules();
+	EasyTerm::startUsingModule(vmod);
+}
+
+EasyRewriter::~EasyRewriter() {
+	delete context;
+	(void) vmod->unprotect();
+}
+
+pair<EasyTerm*, int>
+EasyRewriter::step(int steps) {
+	Int64 before = context->getTotalCount();
+
+	if (!finished && steps != 0) {
+		Int64 rulesBefore = context->getRlCount();
+
+		if (mode == REWRITE)
+			context->ruleRewrite(steps);
+		else if (!started)
+			context->fairRewrite(steps, (gas == NONE) ? 1 : gas);
+		else
+			context->fairContinue(steps);
+
+		started = true;
+
+		// The session ends when fewer rules than allowed have
+		// been applied, unless it has been interrupted
+		if (!UserLevelRewritingContext::aborted())
+			finished = steps == NONE || context->getRlCount() - rulesBefore < steps;
+	}
+
+	return {new EasyTerm(context->root()), int(context->getTotalCount() - before)};
+}
+
+EasyTerm*
+EasyRewriter::getState() const {
+	return new EasyTerm(context->root());
+}
+
+int
+EasyRewriter::getRewriteCount() const {
+	return context->getTotalCount();
+}
+
+RewriteStats
+EasyRewriter::getStats() const {
+	return StatsRecorder::fromContext(context);
+}
@@ -0,0 +1,85 @@
+/**
+ * @file rewriter.hh
+ *
+ * Resumable rewriting sessions.
+ */
+
+#ifndef REWRITER_HH
+#define REWRITER_HH
+
+#include "easyTerm.hh"
+
+#include <utility>
+
+class UserLevelRewritingContext;
+
+/**
+ * Rewriting session that keeps its rewriting context alive between
+ * calls, so that a long rewrite can be executed in slices.
+ */
+class EasyRewriter {
+public:
+	/**
+	 * Rewriting modes.
+	 */
+	enum Mode {
+		REWRITE,	///< Following the semantics of the @c rewrite command.
+		FREWRITE,	///< Following the semantics of the @c frewrite command.
+	};
+
+	/**
+	 * Start a rewriting session.
+	 *
+	 * @param term Initial term (it is not modified).
+	 * @param mode Rewriting mode.
+	 * @param gas An upper bound on the number of rule rewrites per position
+	 * in a traversal (only for @c FREWRITE).
+	 */
+	EasyRewriter(EasyTerm* term, Mode mode = REWRITE, int gas = NONE);
+	~EasyRewriter();
+
+	/**
+	 * Execute more rule rewrites.
+	 *
+	 * @param steps An upper bound on the number of rule rewrites
+	 * (@c -1 for no bound).
+	 *
+	 * @return The current state and the number of rewrites in this step.
+	 */
+	std::pair<EasyTerm*, int> step(int steps = NONE);
+
+	/**
+	 * Get the current state.
+	 */
+	EasyTerm* getState() const;
+
+	/**
+	 * Whether no more rule rewrites can be applied.
+	 */
+	bool isFinished() const;
+
+	/**
+	 * Get the total number of rewrites since the start of the session.
+	 */
+	int getRewriteCount() const;
+
+	/**
+	 * Get the rewrite counts since the start of the session.
+	 */
+	RewriteStats getStats() const;
+
+private:
+	VisibleModule* vmod;
+	UserLevelRewritingContext* context;
+	Mode mode;
+	int gas;
+	bool started = false;
+	bool finished = false;
+};
+
+inline bool
+EasyRewriter::isFinished() const {
+	return finished;
+}
+
+#endif // REWRITER_HH
@@ -0,0 +1,103 @@
+/**
+ * @file root_pool.hh
+ *
+ * Pooled roots for the garbage collector.
+ */
+
+#ifndef ROOT_POOL_HH
+#define ROOT_POOL_HH
+
+#include "macros.hh"
+#include "vector.hh"
+#include "core.hh"
+#include "rootContainer.hh"
+
+#include <vector>
+
+/**
+ * Table of objects that keep DAG nodes alive, which is registered as a
+ * single root container of the garbage collector.
+ *
+ * Objects do not need to be linked to the list of root containers one by
+ * one, and their nodes are marked with a loop over a contiguous array
+ * instead of a virtual call per object. The table is kept without holes
+ * by moving the last object to the slot of a released one.
+ *
+ * @tparam T Class of the objects, which must have a @c rootSlot member
+ * with its position in the table and a @c markReachableNodes method.
+ */
+template<typename T>
+class RootPool : private RootContainer {
+public:
+	/**
+	 * Protect the nodes of an object.
+	 */
+	static void link(T* object);
+
+	/**
+	 * Stop protecting the nodes of an object.
+	 */
+	static void unlink(T* object);
+
+	/**
+	 * Get the number of objects in the table.
+	 */
+	static size_t size();
+
+private:
+	RootPool();
+
+	static RootPool& instance();
+
+	void markReachableNodes();
+
+	std::vector<T*> objects;
+};
+
+template<typename T>
+RootPool<T>::RootPool() {
+	RootContainer::link();
+}
+
+template<typename T>
+inline RootPool<T>&
+RootPool<T>::instance() {
+	// Never destroyed, since nodes may be marked until the end
+	static RootPool* pool = new RootPool;
+	return *pool;
+}
+
+template<typename T>
+inline void
+RootPool<T>::link(T* object) {
+	std::vector<T*> &objects = instance().objects;
+
+	object->rootSlot = objects.size();
+	objects.push_back(object);
+}
+
+template<typename T>
+inline void
+RootPool<T>::unlink(T* object) {
+	std::vector<T*> &objects = instance().objects;
+
+	T* last = objects.back();
+	objects[object->rootSlot] = last;
+	last->rootSlot = object->rootSlot;
+	objects.pop_back();
+}
+
+template<typename T>
+inline size_t
+RootPool<T>::size() {
+	return instance().objects.size();
+}
+
+template<typename T>
+void
+RootPool<T>::markReachableNodes() {
+	for (T* object : objects)
+		object->markReachableNodes();
+}
+
+#endif // ROOT_POOL_HH
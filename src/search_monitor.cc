@@ -0,0 +1,263 @@
+/**
+ * @file search_monitor.cc
+ *
+ * Progress counters and periodic callbacks of searches.
+ */
+
+#include "search_monitor.hh"
+#include "trace_recorder.hh"
+#include "maude_wrappers.hh"
+
+#include "macros.hh"
+#include "vector.hh"
+#include "core.hh"
+#include "interface.hh"
+#include "mixfix.hh"
+#include "higher.hh"
+#include "strategyLanguage.hh"
+#include "userLevelRewritingContext.hh"
+#include "interpreter.hh"
+#include "global.hh"
+#include "rewriteSequenceSearch.hh"
+#include "strategySequenceSearch.hh"
+#include "best_first_search.hh"
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
+using namespace std;
+
+SearchMonitor* SearchMonitor::current = nullptr;
+
+SearchMonitor::~SearchMonitor() {
+	if (current == this)
+		current = nullptr;
+}
+
+void
+SearchMonitor::setCallback(ProgressCallback* callback, long long everyStates, double everyMillis) {
+	this->callback = callback;
+	this->everyStates = everyStates;
+	this->everyMillis = everyMillis;
+	lastStates = countStates();
+	lastReport = Clock::now();
+}
+
+double
+SearchMonitor::getElapsed() const {
+	Clock::duration total = elapsed;
+
+	if (nesting > 0)
+		total += Clock::now() - startTime;
+
+	return chrono::duration<double>(total).count();
+}
+
+SearchProgress
+SearchMonitor::getProgress() const {
+	SearchProgress progress = {-1, -1, -1, -1, -1, -1, 0.0, 0.0};
+	sample(progress);
+
+	progress.elapsed = getElapsed();
+
+	if (progress.elapsed > 0)
+		progress.statesPerSecond = progress.nrStates / progress.elapsed;
+
+	return progress;
+}
+
+void
+SearchMonitor::check() {
+	if (callback == nullptr)
+		return;
+
+	long long nrStates = countStates();
+	Clock::time_point now = Clock::now();
+
+	if ((everyStates > 0 && nrStates - lastStates >= everyStates)
+	    || (everyMillis > 0 && chrono::duration<double, milli>(now - lastReport).count() >= everyMillis)) {
+		lastStates = nrStates;
+		lastReport = now;
+
+		// The callback is not monitored itself
+		SearchMonitor* running = current;
+		current = nullptr;
+		callback->report(getProgress());
+		current = running;
+	}
+}
+
+SearchMonitor::Scope::Scope(SearchMonitor* monitor, bool fromEngine)
+ : monitor(monitor), previous(current),
+   fromEngine(fromEngine && monitor != nullptr && monitor->callback != nullptr)
+{
+	if (monitor == nullptr)
+		return;
+
+	if (monitor->nesting++ == 0)
+		monitor->startTime = Clock::now();
+
+	// The engine only reports to monitors with a callback
+	if (!this->fromEngine)
+		return;
+
+	current = monitor;
+
+	// The callback is called from the trace hooks of the rewriting
+	// context, which are only used when tracing is enabled
+	UserLevelRewritingContext::setTraceStatus(true);
+}
+
+SearchMonitor::Scope::~Scope() {
+	if (monitor == nullptr)
+		return;
+
+	if (--monitor->nesting == 0)
+		monitor->elapsed += Clock::now() - monitor->startTime;
+
+	if (!fromEngine)
+		return;
+
+	current = previous;
+
+	refreshTraceStatus();
+}
+
+namespace {
+
+// Number of steps from the initial state to the given one
+template<typename Graph>
+int
+stateDepth(const Graph* graph, int stateNr) {
+	int depth = 0;
+
+	for (int parent = graph->getStateParent(stateNr); parent >= 0; parent = graph->getStateParent(parent))
+		depth++;
+
+	return depth;
+}
+
+/**
+ * Monitor of a search or rewrite graph of Maude.
+ */
+template<typename Graph>
+class GraphMonitor : public SearchMonitor {
+public:
+	GraphMonitor(Graph* graph) : graph(graph) {}
+
+protected:
+	long long countStates() const override {
+		return graph->getNrStates();
+	}
+
+	void sample(SearchProgress &progress) const override;
+
+private:
+	Graph* graph;
+};
+
+// Counters available for graphs with parent links (the number of
+// duplicates is estimated from the rule rewrites, each of which yields
+// a successor)
+template<typename Graph>
+void
+sampleTree(const Graph* graph, RewritingContext* context, SearchProgress &progress) {
+	int nrStates = graph->getNrStates();
+
+	progress.nrStates = nrStates;
+	progress.rewrites = context->getTotalCount();
+	progress.nrDuplicates = max(context->getRlCount() - (nrStates - 1), Int64(0));
+	progress.depth = nrStates > 0 ? stateDepth(graph, nrStates - 1) : 0;
+}
+
+template<>
+void
+GraphMonitor<RewriteSequenceSearch>::sample(SearchProgress &progress) const {
+	sampleTree(graph, graph->getContext(), progress);
+
+	// States are expanded in order, so the parent of the last state is
+	// the one being expanded and the following ones are pending
+	int nrStates = graph->getNrStates();
+	progress.frontierSize = nrStates > 1 ? nrStates - 1 - graph->getStateParent(nrStates - 1) : nrStates;
+}
+
+template<>
+void
+GraphMonitor<StrategySequenceSearch>::sample(SearchProgress &progress) const {
+	sampleTree(graph, graph->getContext(), progress);
+}
+
+template<>
+void
+GraphMonitor<BestFirstSearch>::sample(SearchProgress &progress) const {
+	progress.nrStates = graph->getNrStates();
+	progress.nrDuplicates = graph->getNrDuplicates();
+	progress.frontierSize = graph->getFrontierSize();
+	progress.depth = graph->getMaxDepthReached();
+	progress.rewrites = graph->getContext()->getTotalCount();
+}
+
+template<>
+void
+GraphMonitor<StateTransitionGraph>::sample(SearchProgress &progress) const {
+	sampleTree(graph, graph->getContext(), progress);
+}
+
+template<>
+void
+GraphMonitor<StrategyTransitionGraph>::sample(SearchProgress &progress) const {
+	progress.nrStates = graph->getNrStates();
+	progress.rewrites = graph->getContext()->getTotalCount();
+}
+
+unordered_map<const void*, unique_ptr<SearchMonitor>> monitors;
+
+template<typename Graph>
+SearchMonitor*
+makeMonitor(Graph* graph) {
+	unique_ptr<SearchMonitor> &monitor = monitors[graph];
+
+	if (monitor == nullptr)
+		monitor = make_unique<GraphMonitor<Graph>>(graph);
+
+	return monitor.get();
+}
+
+}
+
+SearchMonitor*
+getMonitor(RewriteSequenceSearch* search) {
+	return makeMonitor(search);
+}
+
+SearchMonitor*
+getMonitor(StrategySequenceSearch* search) {
+	return makeMonitor(search);
+}
+
+SearchMonitor*
+getMonitor(BestFirstSearch* search) {
+	return makeMonitor(search);
+}
+
+SearchMonitor*
+getMonitor(StateTransitionGraph* graph) {
+	return makeMonitor(graph);
+}
+
+SearchMonitor*
+getMonitor(StrategyTransitionGraph* graph) {
+	return makeMonitor(graph);
+}
+
+SearchMonitor*
+findMonitor(const void* object) {
+	auto it = monitors.find(object);
+	return it != monitors.end() ? it->second.get() : nullptr;
+}
+
+void
+forgetMonitor(const void* object) {
+	monitors.erase(object);
+}
@@ -0,0 +1,164 @@
+/**
+ * @file search_monitor.hh
+ *
+ * Progress counters and periodic callbacks of searches.
+ */
+
+#ifndef SEARCH_MONITOR_HH
+#define SEARCH_MONITOR_HH
+
+#include <chrono>
+
+class RewriteSequenceSearch;
+class StrategySequenceSearch;
+class StateTransitionGraph;
+class StrategyTransitionGraph;
+class BestFirstSearch;
+
+/**
+ * Snapshot of the progress of a search.
+ *
+ * Counters that are not available for a kind of search are @c -1. The
+ * time of the searches of Maude is only measured once their monitor has
+ * been created.
+ */
+struct SearchProgress {
+	long long nrStates;		///< Number of distinct states generated.
+	long long nrDuplicates;		///< Number of successors that had already been visited.
+	long long frontierSize;		///< Number of states pending exploration.
+	int depth;			///< Depth of the deepest state generated.
+	long long rewrites;		///< Number of rewrites.
+	long long storageBytes;		///< Bytes used to store states outside the Maude heap.
+	double elapsed;			///< Seconds spent in the search.
+	double statesPerSecond;		///< Average number of states generated per second.
+};
+
+/**
+ * Callback for the progress of a search.
+ */
+struct ProgressCallback {
+	/**
+	 * Method called periodically during the search.
+	 *
+	 * The search can be stopped from here by cancelling an active
+	 * cancellation token. Maude operations should not be executed
+	 * in the callback.
+	 *
+	 * @param progress Current progress of the search.
+	 */
+	virtual void report(const SearchProgress &progress) = 0;
+	virtual ~ProgressCallback() {};
+};
+
+/**
+ * Monitor of the progress of a search that keeps its running time and
+ * calls a callback every given number of states or milliseconds.
+ */
+class SearchMonitor {
+public:
+	SearchMonitor() = default;
+	virtual ~SearchMonitor();
+
+	/**
+	 * Set the progress callback.
+	 *
+	 * @param callback Callback object (that must outlive the search) or
+	 * null to remove the current one.
+	 * @param everyStates Number of new states between calls (non-positive
+	 * to disable this criterion).
+	 * @param everyMillis Milliseconds between calls (non-positive to
+	 * disable this criterion).
+	 */
+	void setCallback(ProgressCallback* callback, long long everyStates, double everyMillis);
+
+	/**
+	 * Get the current progress.
+	 */
+	SearchProgress getProgress() const;
+
+	/**
+	 * Call the callback if any of its periods has elapsed.
+	 */
+	void check();
+
+	/**
+	 * Monitor of the search currently running (if any).
+	 */
+	static SearchMonitor* current;
+
+	/**
+	 * Whether a search with a progress callback is running.
+	 */
+	static bool isMonitoring();
+
+	/**
+	 * Region where the search makes progress, whose time is measured.
+	 */
+	class Scope {
+	public:
+		/**
+		 * Enter the region.
+		 *
+		 * @param monitor Monitor of the search (nothing is done if null).
+		 * @param fromEngine Whether the callback is checked by the
+		 * rewriting engine at every rule rewrite (otherwise, the search
+		 * calls check by itself). The engine is only involved if the
+		 * monitor has a callback.
+		 */
+		Scope(SearchMonitor* monitor, bool fromEngine = true);
+		~Scope();
+
+	private:
+		SearchMonitor* monitor;
+		SearchMonitor* previous;
+		bool fromEngine;
+	};
+
+protected:
+	/**
+	 * Get the number of distinct states generated.
+	 */
+	virtual long long countStates() const = 0;
+
+	/**
+	 * Fill the counters of the search.
+	 */
+	virtual void sample(SearchProgress &progress) const = 0;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	double getElapsed() const;
+
+	ProgressCallback* callback = nullptr;
+	long long everyStates = 0;
+	double everyMillis = 0;
+	long long lastStates = 0;
+	Clock::time_point lastReport;
+
+	// Accumulated running time and start of the current scope
+	Clock::duration elapsed = Clock::duration::zero();
+	Clock::time_point startTime;
+	int nesting = 0;
+};
+
+inline bool
+SearchMonitor::isMonitoring() {
+	return current != nullptr && current->callback != nullptr;
+}
+
+//
+// Monitors of the searches and graphs of Maude, which are created on
+// demand and removed when the objects are deleted.
+//
+
+SearchMonitor* getMonitor(RewriteSequenceSearch* search);
+SearchMonitor* getMonitor(StrategySequenceSearch* search);
+SearchMonitor* getMonitor(BestFirstSearch* search);
+SearchMonitor* getMonitor(StateTransitionGraph* graph);
+SearchMonitor* getMonitor(StrategyTransitionGraph* graph);
+// Monitor of an object only if it has already been created
+SearchMonitor* findMonitor(const void* object);
+void forgetMonitor(const void* object);
+
+#endif // SEARCH_MONITOR_HH
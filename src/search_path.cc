@@ -0,0 +1,169 @@
+/**
+ * @file search_path.cc
+ *
+ * Extraction of whole paths from search and rewrite graphs.
+ */
+
+#include "search_path.hh"
+
+#include "rewriteSequenceSearch.hh"
+#include "strategySequenceSearch.hh"
+
+#include <algorithm>
+#include <queue>
+
+using namespace std;
+
+namespace {
+
+// Follow the parents of a state up to the initial one
+template<typename Graph>
+vector<int>
+followParents(const Graph &graph, int stateNr) {
+	vector<int> states;
+
+	if (stateNr < 0 || stateNr >= graph.getNrStates())
+		return states;
+
+	// The parent of the initial state is negative
+	for (int current = stateNr; current >= 0; current = graph.getStateParent(current))
+		states.push_back(current);
+
+	reverse(states.begin(), states.end());
+	return states;
+}
+
+// Rule between two consecutive states of a rewrite graph
+Rule*
+arcRule(StateTransitionGraph &graph, int origin, int dest) {
+	auto &arcs = graph.getStateFwdArcs(origin);
+	auto it = arcs.find(dest);
+
+	return it == arcs.end() || it->second.empty() ? nullptr : *it->second.begin();
+}
+
+// Transition between two consecutive states of a strategy graph
+const StrategyTransitionGraph::Transition*
+arcTransition(StrategyTransitionGraph &graph, int origin, int dest) {
+	auto &arcs = graph.getStateFwdArcs(origin);
+	auto it = arcs.find(dest);
+
+	return it == arcs.end() || it->second.empty() ? nullptr : &*it->second.begin();
+}
+
+// Build the steps of a path from its state numbers
+template<typename Graph, typename Connect>
+vector<PathStep>
+makeSteps(Graph &graph, const vector<int> &states, Connect connect) {
+	vector<PathStep> steps;
+	steps.reserve(states.size());
+
+	for (size_t i = 0; i < states.size(); i++) {
+		PathStep step = {states[i], new EasyTerm(graph.getStateDag(states[i])), nullptr, nullptr};
+
+		if (i > 0)
+			connect(step, states[i - 1]);
+
+		steps.push_back(step);
+	}
+
+	return steps;
+}
+
+}
+
+vector<int>
+getPathStates(RewriteSequenceSearch &search, int stateNr) {
+	return followParents(search, stateNr == -1 ? search.getStateNr() : stateNr);
+}
+
+vector<int>
+getPathStates(StrategySequenceSearch &search, int stateNr) {
+	return followParents(search, stateNr == -1 ? search.getStateNr() : stateNr);
+}
+
+vector<int>
+getPathStates(BestFirstSearch &search, int stateNr) {
+	return followParents(search, stateNr == -1 ? search.getStateNr() : stateNr);
+}
+
+vector<int>
+getPathStates(StateTransitionGraph &graph, int stateNr) {
+	return followParents(graph, stateNr);
+}
+
+vector<int>
+getPathStates(StrategyTransitionGraph &graph, int stateNr) {
+	int nrStates = graph.getNrStates();
+
+	if (stateNr < 0 || stateNr >= nrStates)
+		return {};
+
+	// Strategy graphs do not record parents, so they are obtained by a
+	// breadth-first traversal of the explored part of the graph, which
+	// yields a shortest path
+	vector<int> parent(nrStates, NONE);
+	queue<int> pending;
+
+	parent[0] = 0;
+	pending.push(0);
+
+	while (!pending.empty() && parent[stateNr] == NONE) {
+		int current = pending.front();
+		pending.pop();
+
+		for (auto &arc : graph.getStateFwdArcs(current))
+			if (arc.first < nrStates && parent[arc.first] == NONE) {
+				parent[arc.first] = current;
+				pending.push(arc.first);
+			}
+	}
+
+	if (parent[stateNr] == NONE)
+		return {};
+
+	vector<int> states = {stateNr};
+
+	for (int current = stateNr; current != 0; current = parent[current])
+		states.push_back(parent[current]);
+
+	reverse(states.begin(), states.end());
+	return states;
+}
+
+vector<PathStep>
+getPath(RewriteSequenceSearch &search, int stateNr) {
+	return makeSteps(search, getPathStates(search, stateNr), [&search] (PathStep &step, int) {
+		step.rule = search.getStateRule(step.stateNr);
+	});
+}
+
+vector<PathStep>
+getPath(StrategySequenceSearch &search, int stateNr) {
+	return makeSteps(search, getPathStates(search, stateNr), [&search] (PathStep &step, int) {
+		step.transition = &search.getStateTransition(step.stateNr);
+		step.rule = step.transition->getRule();
+	});
+}
+
+vector<PathStep>
+getPath(BestFirstSearch &search, int stateNr) {
+	return makeSteps(search, getPathStates(search, stateNr), [&search] (PathStep &step, int) {
+		step.rule = search.getStateRule(step.stateNr);
+	});
+}
+
+vector<PathStep>
+getPath(StateTransitionGraph &graph, int stateNr) {
+	return makeSteps(graph, getPathStates(graph, stateNr), [&graph] (PathStep &step, int origin) {
+		step.rule = arcRule(graph, origin, step.stateNr);
+	});
+}
+
+vector<PathStep>
+getPath(StrategyTransitionGraph &graph, int stateNr) {
+	return makeSteps(graph, getPathStates(graph, stateNr), [&graph] (PathStep &step, int origin) {
+		step.transition = arcTransition(graph, origin, step.stateNr);
+		step.rule = step.transition != nullptr ? step.transition->getRule() : nullptr;
+	});
+}
@@ -0,0 +1,44 @@
+/**
+ * @file search_path.hh
+ *
+ * Extraction of whole paths from search and rewrite graphs.
+ */
+
+#ifndef SEARCH_PATH_HH
+#define SEARCH_PATH_HH
+
+#include "easyTerm.hh"
+#include "strategyTransitionGraph.hh"
+#include "best_first_search.hh"
+
+#include <vector>
+
+/**
+ * Step of a path in a search or rewrite graph.
+ */
+struct PathStep {
+	int stateNr;		///< State number.
+	EasyTerm* term;		///< State term.
+	Rule* rule;		///< Rule leading to the state (null for the first one or non-rule transitions).
+	const StrategyTransitionGraph::Transition* transition;	///< Transition leading to the state (in strategy-controlled graphs).
+};
+
+//
+// Path from the initial state to the given one (or to the current
+// state of a search if -1) as a sequence of state numbers or steps.
+// The path is empty if the state is not valid.
+//
+
+std::vector<int> getPathStates(RewriteSequenceSearch &search, int stateNr = -1);
+std::vector<int> getPathStates(StrategySequenceSearch &search, int stateNr = -1);
+std::vector<int> getPathStates(BestFirstSearch &search, int stateNr = -1);
+std::vector<int> getPathStates(StateTransitionGraph &graph, int stateNr);
+std::vector<int> getPathStates(StrategyTransitionGraph &graph, int stateNr);
+
+std::vector<PathStep> getPath(RewriteSequenceSearch &search, int stateNr = -1);
+std::vector<PathStep> getPath(StrategySequenceSearch &search, int stateNr = -1);
+std::vector<PathStep> getPath(BestFirstSearch &search, int stateNr = -1);
+std::vector<PathStep> getPath(StateTransitionGraph &graph, int stateNr);
+std::vector<PathStep> getPath(StrategyTransitionGraph &graph, int stateNr);
+
+#endif // SEARCH_PATH_HH
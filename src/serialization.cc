@@ -0,0 +1,516 @@
+/**
+ * @file serialization.cc
+ *
+ * Compact binary serialization and flat export of terms.
+ */
+
+#include "easyTerm.hh"
+#include "maude_wrappers.hh"
+
+#include "dagNode.hh"
+#include "dagArgumentIterator.hh"
+#include "userLevelRewritingContext.hh"
+#include "visibleModule.hh"
+#include "variableSymbol.hh"
+#include "variableDagNode.hh"
+
+// for theory-specific nodes
+#include "NA_Theory.hh"
+#include "floatSymbol.hh"
+#include "floatDagNode.hh"
+#include "stringSymbol.hh"
+#include "stringDagNode.hh"
+#include "quotedIdentifierSymbol.hh"
+#include "quotedIdentifierDagNode.hh"
+#include "SMT_NumberSymbol.hh"
+#include "SMT_NumberDagNode.hh"
+#include "S_Theory.hh"
+#include "S_Symbol.hh"
+#include "S_DagNode.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+
+using namespace std;
+
+//
+// The encoding consists of a header with a format version and the module
+// name, a table of the symbols used in the term (with their index in the
+// module, name, arity and range sort name to check and recover them), and
+// the nodes of the DAG in postorder. Arguments are referenced by the index
+// of their nodes, so that sharing is preserved. Integers are written as
+// variable-length sequences of 7-bit groups.
+//
+
+namespace {
+
+const int FORMAT_VERSION = 1;
+
+enum NodeType {
+	SYMBOL_NODE,	// any symbol applied to its arguments
+	VARIABLE_NODE,	// variable (sort and name)
+	FLOAT_NODE,	// floating-point number
+	STRING_NODE,	// string
+	QID_NODE,	// quoted identifier
+	ITER_NODE,	// iterated symbol (exponent and argument)
+	SMT_NODE,	// SMT number (rational)
+
+	REDUCED_FLAG = 0x80
+};
+
+class Writer {
+public:
+	void putNat(size_t value) {
+		while (value >= 0x80) {
+			buffer.push_back(char(value & 0x7f) | 0x80);
+			value >>= 7;
+		}
+		buffer.push_back(char(value));
+	}
+
+	void putString(const string &str) {
+		putNat(str.size());
+		buffer.append(str);
+	}
+
+	void putByte(int value) {
+		buffer.push_back(char(value));
+	}
+
+	void putDouble(double value) {
+		buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	string buffer;
+};
+
+class Reader {
+public:
+	Reader(const string &data) : data(data) {}
+
+	size_t getNat() {
+		size_t value = 0;
+		for (int shift = 0; position < data.size(); shift += 7) {
+			unsigned char byte = data[position++];
+			value |= size_t(byte & 0x7f) << shift;
+			if (!(byte & 0x80))
+				return value;
+		}
+		failed = true;
+		return 0;
+	}
+
+	string getString() {
+		size_t length = getNat();
+		if (position + length > data.size()) {
+			failed = true;
+			return "";
+		}
+		string str = data.substr(position, length);
+		position += length;
+		return str;
+	}
+
+	int getByte() {
+		if (position >= data.size()) {
+			failed = true;
+			return 0;
+		}
+		return (unsigned char) data[position++];
+	}
+
+	double getDouble() {
+		double value = 0.0;
+		if (position + sizeof(value) > data.size())
+			failed = true;
+		else {
+			memcpy(&value, data.data() + position, sizeof(value));
+			position += sizeof(value);
+		}
+		return value;
+	}
+
+	const string &data;
+	size_t position = 0;
+	bool failed = false;
+};
+
+inline string
+ropeToString(const Rope &rope) {
+	char* str = rope.makeZeroTerminatedString();
+	string result(str);
+	delete [] str;
+	return result;
+}
+
+// Find a symbol by name, arity and range sort name
+Symbol*
+findSymbol(VisibleModule* vmod, size_t index, int name, size_t arity, int rangeName) {
+	const Vector<Symbol*> &symbols = vmod->getSymbols();
+
+	auto matches = [&](Symbol* symbol) {
+		return symbol->id() == name && size_t(symbol->arity()) == arity
+			&& symbol->getRangeSort()->id() == rangeName;
+	};
+
+	// The index within the module is tried first
+	if (index < size_t(symbols.size()) && matches(symbols[index]))
+		return symbols[index];
+
+	for (Symbol* symbol : symbols)
+		if (matches(symbol))
+			return symbol;
+
+	return nullptr;
+}
+
+}
+
+string
+EasyTerm::serialize() {
+	if (!is_dag)
+		dagify();
+
+	Module* mod = dagNode->symbol()->getModule();
+
+	map<Symbol*, size_t> symbolTable;
+	vector<Symbol*> symbols;
+	map<DagNode*, size_t> nodeIndex;
+	Writer nodes;
+	size_t nrNodes = 0;
+
+	auto symbolNr = [&](Symbol* symbol) {
+		auto [it, inserted] = symbolTable.insert({symbol, symbols.size()});
+		if (inserted)
+			symbols.push_back(symbol);
+		return it->second;
+	};
+
+	// Iterative postorder traversal of the DAG (the second component
+	// of the stack entries tells whether the arguments have been visited)
+	vector<pair<DagNode*, bool>> pending = {{dagNode, false}};
+
+	while (!pending.empty()) {
+		auto [node, expanded] = pending.back();
+
+		if (nodeIndex.find(node) != nodeIndex.end()) {
+			pending.pop_back();
+			continue;
+		}
+
+		if (!expanded) {
+			pending.back().second = true;
+
+			// Arguments are pushed in reverse order
+			size_t start = pending.size();
+			for (DagArgumentIterator it(node); it.valid(); it.next())
+				pending.push_back({it.argument(), false});
+			reverse(pending.begin() + start, pending.end());
+			continue;
+		}
+
+		pending.pop_back();
+		int reduced = node->isReduced() ? REDUCED_FLAG : 0;
+
+		if (auto vnode = dynamic_cast<VariableDagNode*>(node)) {
+			Sort* sort = safeCast(VariableSymbol*, vnode->symbol())->getSort();
+			nodes.putByte(VARIABLE_NODE | reduced);
+			nodes.putNat(sort->component()->getIndexWithinModule());
+			nodes.putNat(sort->index());
+			nodes.putString(Token::name(vnode->id()));
+		}
+		else if (auto fnode = dynamic_cast<FloatDagNode*>(node)) {
+			nodes.putByte(FLOAT_NODE | reduced);
+			nodes.putNat(symbolNr(node->symbol()));
+			nodes.putDouble(fnode->getValue());
+		}
+		else if (auto snode = dynamic_cast<StringDagNode*>(node)) {
+			nodes.putByte(STRING_NODE | reduced);
+			nodes.putNat(symbolNr(node->symbol()));
+			nodes.putString(ropeToString(snode->getValue()));
+		}
+		else if (auto qnode = dynamic_cast<QuotedIdentifierDagNode*>(node)) {
+			nodes.putByte(QID_NODE | reduced);
+			nodes.putNat(symbolNr(node->symbol()));
+			nodes.putString(Token::name(qnode->getIdIndex()));
+		}
+		else if (auto inode = dynamic_cast<S_DagNode*>(node)) {
+			nodes.putByte(ITER_NODE | reduced);
+			nodes.putNat(symbolNr(node->symbol()));
+			nodes.putString(inode->getNumber().get_str(16));
+			nodes.putNat(nodeIndex[inode->getArgument()]);
+		}
+		else if (auto mnode = dynamic_cast<SMT_NumberDagNode*>(node)) {
+			nodes.putByte(SMT_NODE | reduced);
+			nodes.putNat(symbolNr(node->symbol()));
+			nodes.putString(mnode->getValue().get_str(16));
+		}
+		else if (dynamic_cast<NA_DagNode*>(node) != nullptr) {
+			IssueWarning("cannot serialize the built-in constant " << QUOTE(node) << ".");
+			return "";
+		}
+		else {
+			nodes.putByte(SYMBOL_NODE | reduced);
+			nodes.putNat(symbolNr(node->symbol()));
+
+			size_t nrArgs = 0;
+			for (DagArgumentIterator it(node); it.valid(); it.next())
+				nrArgs++;
+
+			nodes.putNat(nrArgs);
+			for (DagArgumentIterator it(node); it.valid(); it.next())
+				nodes.putNat(nodeIndex[it.argument()]);
+		}
+
+		nodeIndex[node] = nrNodes++;
+	}
+
+	// Header and symbol table
+	Writer output;
+
+	output.putNat(FORMAT_VERSION);
+	output.putString(Token::name(mod->id()));
+	output.putNat(symbols.size());
+
+	for (Symbol* symbol : symbols) {
+		output.putNat(symbol->getIndexWithinModule());
+		output.putString(Token::name(symbol->id()));
+		output.putNat(symbol->arity());
+		output.putString(Token::name(symbol->getRangeSort()->id()));
+	}
+
+	output.putNat(nrNodes);
+	output.buffer.append(nodes.buffer);
+
+	return output.buffer;
+}
+
+EasyTerm*
+EasyTerm::deserialize(VisibleModule* vmod, const string &data) {
+	Reader input(data);
+
+	if (input.getNat() != FORMAT_VERSION) {
+		IssueWarning("unknown term serialization format.");
+		return nullptr;
+	}
+
+	string moduleName = input.getString();
+
+	// The module is looked up by name if not given
+	bool ownModule = vmod == nullptr;
+
+	if (ownModule && (vmod = getModule(moduleName.c_str())) == nullptr) {
+		IssueWarning("cannot find module " << QUOTE(moduleName) << " to deserialize the term.");
+		return nullptr;
+	}
+
+	// Symbol table
+	size_t nrSymbols = input.getNat();
+	vector<Symbol*> symbols;
+
+	for (size_t i = 0; i < nrSymbols && !input.failed; i++) {
+		size_t index = input.getNat();
+		string name = input.getString();
+		size_t arity = input.getNat();
+		string range = input.getString();
+
+		Symbol* symbol = findSymbol(vmod, index, Token::encode(name.c_str()), arity, Token::encode(range.c_str()));
+
+		if (symbol == nullptr) {
+			IssueWarning("cannot find symbol " << QUOTE(name) << " of arity " << arity
+				<< " in module " << QUOTE(Token::name(vmod->id())) << ".");
+			input.failed = true;
+		}
+
+		symbols.push_back(symbol);
+	}
+
+	// Nodes (no garbage collection happens while they are built)
+	size_t nrNodes = input.failed ? 0 : input.getNat();
+	const Vector<ConnectedComponent*> &kinds = vmod->getConnectedComponents();
+
+	vector<DagNode*> nodes;
+	vector<size_t> reducedNodes;
+	Vector<DagNode*> args;
+
+	auto getSymbol = [&]() -> Symbol* {
+		size_t index = input.getNat();
+		if (index < symbols.size())
+			return symbols[index];
+		input.failed = true;
+		return nullptr;
+	};
+
+	auto getNode = [&]() -> DagNode* {
+		size_t index = input.getNat();
+		if (index < nodes.size())
+			return nodes[index];
+		input.failed = true;
+		return nullptr;
+	};
+
+	for (size_t i = 0; i < nrNodes && !input.failed; i++) {
+		int type = input.getByte();
+		DagNode* node = nullptr;
+
+		switch (type & ~REDUCED_FLAG) {
+			case SYMBOL_NODE: {
+				Symbol* symbol = getSymbol();
+				size_t nrArgs = input.getNat();
+
+				if (input.failed || symbol == nullptr || nrArgs > data.size())
+					break;
+
+				args.resize(nrArgs);
+				for (size_t j = 0; j < nrArgs; j++)
+					args[j] = getNode();
+
+				// Variadic symbols are flattened in the encoding
+				if (!input.failed && (nrArgs == size_t(symbol->arity()) || nrArgs > 2))
+					node = symbol->makeDagNode(args);
+				break;
+			}
+			case VARIABLE_NODE: {
+				size_t kindIndex = input.getNat();
+				size_t sortIndex = input.getNat();
+				string name = input.getString();
+
+				if (kindIndex < size_t(kinds.size()) && sortIndex < size_t(kinds[kindIndex]->nrSorts())) {
+					Sort* sort = kinds[kindIndex]->sort(sortIndex);
+					node = new VariableDagNode(vmod->instantiateVariable(sort),
+					                           Token::encode(name.c_str()), NONE);
+				}
+				break;
+			}
+			case FLOAT_NODE:
+				if (auto symbol = dynamic_cast<FloatSymbol*>(getSymbol()))
+					node = new FloatDagNode(symbol, input.getDouble());
+				break;
+			case STRING_NODE:
+				if (auto symbol = dynamic_cast<StringSymbol*>(getSymbol()))
+					node = new StringDagNode(symbol, Rope(input.getString().c_str()));
+				break;
+			case QID_NODE:
+				if (auto symbol = dynamic_cast<QuotedIdentifierSymbol*>(getSymbol()))
+					node = new QuotedIdentifierDagNode(symbol, Token::encode(input.getString().c_str()));
+				break;
+			case ITER_NODE:
+				if (auto symbol = dynamic_cast<S_Symbol*>(getSymbol())) {
+					mpz_class number(input.getString(), 16);
+					if (DagNode* arg = getNode())
+						node = new S_DagNode(symbol, number, arg);
+				}
+				break;
+			case SMT_NODE:
+				if (auto symbol = dynamic_cast<SMT_NumberSymbol*>(getSymbol()))
+					node = new SMT_NumberDagNode(symbol, mpq_class(input.getString(), 16));
+				break;
+		}
+
+		if (node == nullptr || input.failed) {
+			input.failed = true;
+			break;
+		}
+
+		if (type & REDUCED_FLAG)
+			reducedNodes.push_back(nodes.size());
+
+		nodes.push_back(node);
+	}
+
+	if (input.failed || nodes.empty()) {
+		IssueWarning("malformed serialized term.");
+		if (ownModule)
+			vmod->unprotect();
+		return nullptr;
+	}
+
+	EasyTerm* term = new EasyTerm(nodes.back());
+
+	// Sorts and the order of the arguments under axioms depend on the
+	// module instance, so they are not taken from the encoding. Nodes
+	// that were reduced are reduced again bottom-up (the term protects
+	// them), which only normalizes them and computes their sorts, since
+	// their arguments have already been reduced and no equation applies
+	UserLevelRewritingContext context(nodes.back());
+
+	for (size_t index : reducedNodes)
+		nodes[index]->reduce(context);
+
+	if (ownModule)
+		vmod->unprotect();
+
+	return term;
+}
+
+FlatTerm*
+EasyTerm::flatten() {
+	if (!is_dag)
+		dagify();
+
+	FlatTerm* flat = new FlatTerm;
+	unordered_map<DagNode*, int> position;
+	unordered_map<string, int> stringIndex;
+
+	auto addNode = [&](int symbol, int arity, double number = NAN, int text = -1) {
+		flat->symbols.push_back(symbol);
+		flat->arities.push_back(arity);
+		flat->numbers.push_back(number);
+		flat->texts.push_back(text);
+	};
+
+	auto textNr = [&](string &&text) {
+		auto [it, inserted] = stringIndex.insert({std::move(text), flat->strings.size()});
+		if (inserted)
+			flat->strings.push_back(it->first);
+		return it->second;
+	};
+
+	// Iterative preorder traversal of the DAG
+	vector<DagNode*> pending = {dagNode};
+
+	while (!pending.empty()) {
+		DagNode* node = pending.back();
+		pending.pop_back();
+
+		auto [seen, inserted] = position.insert({node, flat->symbols.size()});
+
+		// Shared subterms are referenced by their first position
+		if (!inserted) {
+			addNode(-(seen->second + 1), 0);
+			continue;
+		}
+
+		int symbol = node->symbol()->getIndexWithinModule();
+
+		if (auto vnode = dynamic_cast<VariableDagNode*>(node))
+			addNode(symbol, 0, NAN, textNr(Token::name(vnode->id())));
+		else if (auto fnode = dynamic_cast<FloatDagNode*>(node))
+			addNode(symbol, 0, fnode->getValue());
+		else if (auto snode = dynamic_cast<StringDagNode*>(node))
+			addNode(symbol, 0, NAN, textNr(ropeToString(snode->getValue())));
+		else if (auto qnode = dynamic_cast<QuotedIdentifierDagNode*>(node))
+			addNode(symbol, 0, NAN, textNr(Token::name(qnode->getIdIndex())));
+		else if (auto mnode = dynamic_cast<SMT_NumberDagNode*>(node))
+			addNode(symbol, 0, mnode->getValue().get_d(), textNr(mnode->getValue().get_str()));
+		else if (auto inode = dynamic_cast<S_DagNode*>(node)) {
+			const mpz_class &number = inode->getNumber();
+			addNode(symbol, 1, number.get_d(), textNr(number.get_str()));
+			pending.push_back(inode->getArgument());
+		}
+		else {
+			// Arguments are pushed in reverse order
+			size_t start = pending.size();
+			for (DagArgumentIterator it(node); it.valid(); it.next())
+				pending.push_back(it.argument());
+			reverse(pending.begin() + start, pending.end());
+
+			addNode(symbol, pending.size() - start);
+		}
+	}
+
+	return flat;
+}
@@ -0,0 +1,376 @@
+/**
+ * @file simulation.cc
+ *
+ * Monte Carlo simulation of random executions distributed among the
+ * workers of an engine pool.
+ */
+
+#include "macros.hh"
+#include "core.hh"
+#include "interface.hh"
+#include "mixfix.hh"
+#include "higher.hh"
+
+#include "visibleModule.hh"
+#include "userLevelRewritingContext.hh"
+#include "rewriteSearchState.hh"
+#include "dagRoot.hh"
+#include "rule.hh"
+
+#include "simulation.hh"
+
+#include <algorithm>
+#include <memory>
+
+using namespace std;
+
+RandomStepper::RandomStepper(const vector<double> &ruleWeights)
+ : ruleWeights(ruleWeights), uniform(0.0, 1.0) {}
+
+bool
+RandomStepper::setWeight(vector<double> &ruleWeights, VisibleModule* vmod, Rule* rule, double weight) {
+	if (rule->getModule() != vmod) {
+		IssueWarning("the rule does not belong to the module of the initial term.");
+		return false;
+	}
+
+	if (weight < 0.0) {
+		IssueWarning("rule weights cannot be negative.");
+		return false;
+	}
+
+	size_t index = rule->getIndexWithinModule();
+
+	if (index >= ruleWeights.size())
+		ruleWeights.resize(index + 1, 1.0);
+
+	ruleWeights[index] = weight;
+	return true;
+}
+
+void
+RandomStepper::seed(uint64_t seed, uint64_t runNr) {
+	seed_seq sequence{uint32_t(seed), uint32_t(seed >> 32), uint32_t(runNr), uint32_t(runNr >> 32)};
+	generator.seed(sequence);
+}
+
+DagNode*
+RandomStepper::step(DagNode* dag, RewritingContext* parent) {
+	RewritingContext* context = parent->makeSubcontext(dag);
+	RewriteSearchState state(context, UNDEFINED,
+	                         RewriteSearchState::GC_CONTEXT | PositionState::RESPECT_FROZEN,
+	                         0, UNBOUNDED);
+	DagRoot chosen;
+	double totalWeight = 0.0;
+
+	// Weighted reservoir sampling of a single rewrite, so that only
+	// the candidates chosen along the way are instantiated
+	while (state.findNextRewrite()) {
+		size_t index = state.getRule()->getIndexWithinModule();
+		double weight = index < ruleWeights.size() ? ruleWeights[index] : 1.0;
+
+		if (weight > 0.0) {
+			totalWeight += weight;
+
+			if (uniform(generator) * totalWeight < weight)
+				chosen.setNode(state.rebuildDag(state.getReplacement()).first);
+		}
+
+		if (UserLevelRewritingContext::aborted())
+			break;
+	}
+
+	DagNode* successor = nullptr;
+
+	if (chosen.getNode() != nullptr) {
+		context->incrementRlCount();
+
+		RewritingContext* subcontext = context->makeSubcontext(chosen.getNode());
+		subcontext->reduce();
+		context->addInCount(*subcontext);
+		successor = subcontext->root();
+		delete subcontext;
+	}
+
+	parent->addInCount(*context);
+	return successor;
+}
+
+//
+// Worker side
+//
+
+namespace {
+
+double
+observe(Symbol* observable, DagNode* dag, RewritingContext* parent) {
+	Vector<DagNode*> args(1);
+	args[0] = dag;
+
+	RewritingContext* context = parent->makeSubcontext(observable->makeDagNode(args));
+	context->reduce();
+	parent->addInCount(*context);
+
+	double value = EasyTerm(context->root()).toFloat();
+	delete context;
+
+	return value;
+}
+
+bool
+simulateJob(PoolMessage &request, PoolMessage &reply) {
+	unique_ptr<EasyTerm> initial(request.getTerm());
+
+	if (initial == nullptr)
+		return false;
+
+	VisibleModule* vmod = safeCast(VisibleModule*, initial->symbol()->getModule());
+	const Vector<Symbol*> &symbols = vmod->getSymbols();
+
+	int maxSteps = request.getInt();
+	uint64_t seed = request.getInt();
+	long long firstRun = request.getInt();
+	long long nrRuns = request.getInt();
+
+	vector<double> ruleWeights(request.getInt());
+
+	for (double &weight : ruleWeights)
+		weight = request.getDouble();
+
+	vector<Symbol*> observables(request.getInt());
+
+	for (Symbol* &observable : observables)
+		observable = symbols[request.getInt()];
+
+	vector<int> steps(request.getInt());
+
+	for (int &step : steps)
+		step = request.getInt();
+
+	RandomStepper stepper(ruleWeights);
+	UserLevelRewritingContext context(initial->getDag());
+	context.reduce();
+
+	for (long long run = firstRun; run < firstRun + nrRuns; run++) {
+		stepper.seed(seed, run);
+
+		DagRoot state(context.root());
+		int length = 0;
+		bool deadlock = false;
+
+		// Walk until the given step (or a deadlock)
+		auto advance = [&] (int step) {
+			while (length < step && !deadlock && !UserLevelRewritingContext::aborted()) {
+				DagNode* successor = stepper.step(state.getNode(), &context);
+
+				if (successor == nullptr)
+					deadlock = true;
+				else {
+					state.setNode(successor);
+					length++;
+				}
+			}
+		};
+
+		// Observation steps are sorted
+		for (int step : steps) {
+			advance(step);
+
+			for (Symbol* observable : observables)
+				reply.putDouble(observe(observable, state.getNode(), &context));
+		}
+
+		advance(maxSteps);
+		reply.putInt(length);
+
+		if (UserLevelRewritingContext::aborted())
+			return false;
+	}
+
+	reply.putInt(context.getTotalCount());
+	return true;
+}
+
+[[maybe_unused]] bool simulationJobsRegistered =
+	EnginePool::registerJob(EnginePool::SIMULATE_JOB, simulateJob);
+
+}
+
+//
+// Parent side
+//
+
+Simulation::Simulation(EnginePool* pool, EasyTerm* initial, int maxSteps)
+ : pool(pool),
+   vmod(safeCast(VisibleModule*, initial->symbol()->getModule())),
+   initialState(initial->serialize()),
+   maxSteps(max(maxSteps, 0)),
+   steps({this->maxSteps})
+{
+	// Rules and observables are referenced by the simulation
+	vmod->protect();
+}
+
+Simulation::~Simulation() {
+	(void) vmod->unprotect();
+}
+
+bool
+Simulation::setRuleWeight(Rule* rule, double weight) {
+	return RandomStepper::setWeight(ruleWeights, vmod, rule, weight);
+}
+
+bool
+Simulation::addObservable(Symbol* symbol) {
+	if (symbol->getModule() != vmod || symbol->arity() != 1) {
+		IssueWarning("observables must be unary operators of the module of the simulation.");
+		return false;
+	}
+
+	observables.push_back(symbol);
+	observations.assign(observables.size(), {});
+	runLengths.clear();
+	return true;
+}
+
+void
+Simulation::setObservationSteps(const vector<int> &steps) {
+	this->steps.clear();
+
+	for (int step : steps)
+		if (step >= 0 && step <= maxSteps)
+			this->steps.push_back(step);
+
+	sort(this->steps.begin(), this->steps.end());
+	this->steps.erase(unique(this->steps.begin(), this->steps.end()), this->steps.end());
+
+	observations.assign(observables.size(), {});
+	runLengths.clear();
+}
+
+bool
+Simulation::run(int nrRuns, long long seed) {
+	observations.assign(observables.size(), {});
+	runLengths.clear();
+	nrRewrites = 0;
+
+	if (nrRuns < 0) {
+		IssueWarning("the number of runs cannot be negative.");
+		return false;
+	}
+
+	// Runs are split in more jobs than workers to balance the load
+	int nrJobs = min(nrRuns, max(1, pool->getNrWorkers()) * 4);
+	vector<PoolMessage> requests(nrJobs);
+
+	for (int i = 0; i < nrJobs; i++) {
+		long long firstRun = (long long) nrRuns * i / nrJobs;
+		long long lastRun = (long long) nrRuns * (i + 1) / nrJobs;
+
+		PoolMessage &request = requests[i];
+		request.putInt(EnginePool::SIMULATE_JOB);
+		request.putString(initialState);
+		request.putInt(maxSteps);
+		request.putInt(seed);
+		request.putInt(firstRun);
+		request.putInt(lastRun - firstRun);
+
+		request.putInt(ruleWeights.size());
+		for (double weight : ruleWeights)
+			request.putDouble(weight);
+
+		request.putInt(observables.size());
+		for (Symbol* observable : observables)
+			request.putInt(observable->getIndexWithinModule());
+
+		request.putInt(steps.size());
+		for (int step : steps)
+			request.putInt(step);
+	}
+
+	vector<PoolMessage> replies = pool->execute(requests);
+
+	for (int i = 0; i < nrJobs; i++) {
+		PoolMessage &reply = replies[i];
+
+		if (reply.getInt() != EnginePool::JOB_SUCCEEDED) {
+			IssueWarning("the simulation has been interrupted.");
+			observations.assign(observables.size(), {});
+			runLengths.clear();
+			return false;
+		}
+
+		long long nrJobRuns = (long long) nrRuns * (i + 1) / nrJobs - (long long) nrRuns * i / nrJobs;
+
+		for (long long run = 0; run < nrJobRuns; run++) {
+			for (size_t j = 0; j < steps.size(); j++)
+				for (vector<double> &values : observations)
+					values.push_back(reply.getDouble());
+
+			runLengths.push_back(reply.getInt());
+		}
+
+		nrRewrites += reply.getInt();
+	}
+
+	return true;
+}
+
+bool
+Simulation::checkObservable(int observable) const {
+	if (observable < 0 || observable >= int(observables.size())) {
+		IssueWarning("there is no observable with index " << observable << ".");
+		return false;
+	}
+
+	return true;
+}
+
+vector<double>
+Simulation::getObservations(int observable) const {
+	if (!checkObservable(observable))
+		return {};
+
+	return observations[observable];
+}
+
+vector<double>
+Simulation::getMeans(int observable) const {
+	if (!checkObservable(observable))
+		return {};
+
+	const vector<double> &values = observations[observable];
+	size_t nrSteps = steps.size(), nrRuns = runLengths.size();
+	vector<double> means(nrSteps, 0.0);
+
+	for (size_t run = 0; run < nrRuns; run++)
+		for (size_t j = 0; j < nrSteps; j++)
+			means[j] += values[run * nrSteps + j];
+
+	for (double &mean : means)
+		mean /= max(nrRuns, size_t(1));
+
+	return means;
+}
+
+vector<double>
+Simulation::getVariances(int observable) const {
+	if (!checkObservable(observable))
+		return {};
+
+	const vector<double> &values = observations[observable];
+	vector<double> means = getMeans(observable);
+	size_t nrSteps = steps.size(), nrRuns = runLengths.size();
+	vector<double> variances(nrSteps, 0.0);
+
+	for (size_t run = 0; run < nrRuns; run++)
+		for (size_t j = 0; j < nrSteps; j++) {
+			double deviation = values[run * nrSteps + j] - means[j];
+			variances[j] += deviation * deviation;
+		}
+
+	for (double &variance : variances)
+		variance /= max(nrRuns, size_t(2)) - 1;
+
+	return variances;
+}
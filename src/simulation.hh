@@ -0,0 +1,209 @@
+/**
+ * @file simulation.hh
+ *
+ * Monte Carlo simulation of random executions distributed among the
+ * workers of an engine pool.
+ */
+
+#ifndef SIMULATION_HH
+#define SIMULATION_HH
+
+#include "engine_pool.hh"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/**
+ * Random choice among the rule rewrites of a state, where each rewrite
+ * is weighted by the weight of its rule.
+ */
+class RandomStepper {
+public:
+	/**
+	 * @param ruleWeights Weights of the rules indexed by their position
+	 * in the module (rules beyond the end have weight @c 1).
+	 */
+	RandomStepper(const std::vector<double> &ruleWeights);
+
+	/**
+	 * Set the weight of a rule in a table of weights.
+	 *
+	 * @return Whether the rule belongs to the module and the weight
+	 * is valid.
+	 */
+	static bool setWeight(std::vector<double> &ruleWeights, VisibleModule* vmod,
+	                      Rule* rule, double weight);
+
+	/**
+	 * Restart the generator for the given run, so that the sequence of
+	 * choices only depends on the seed and the run number.
+	 */
+	void seed(uint64_t seed, uint64_t runNr);
+
+	/**
+	 * Apply a random rule rewrite to a state.
+	 *
+	 * @param dag Reduced state.
+	 * @param parent Context where the rewrites are counted.
+	 *
+	 * @return The reduced successor (which must be protected by the
+	 * caller) or null if no rule with positive weight applies.
+	 */
+	DagNode* step(DagNode* dag, RewritingContext* parent);
+
+private:
+	const std::vector<double> &ruleWeights;
+	std::mt19937_64 generator;
+	std::uniform_real_distribution<double> uniform;
+};
+
+/**
+ * Monte Carlo simulation that executes a number of independent random
+ * walks of bounded length from an initial term.
+ *
+ * At every step, a rule rewrite of the current state is chosen at random
+ * with probability proportional to the weight of its rule. Observables
+ * are unary operators of the module that are reduced to numbers on the
+ * states at the observation steps. Runs that reach a state without
+ * rewrites stay there, so their later observations repeat the last ones.
+ *
+ * Runs are distributed among the workers of the pool and each one has
+ * its own generator seeded by the simulation seed and the run number,
+ * so the results do not depend on the number of workers.
+ */
+class Simulation {
+public:
+	/**
+	 * Create a simulation.
+	 *
+	 * @param pool Engine pool (that must outlive the simulation).
+	 * @param initial Initial term (it is not modified).
+	 * @param maxSteps Maximum number of rule rewrites per run.
+	 */
+	Simulation(EnginePool* pool, EasyTerm* initial, int maxSteps);
+	~Simulation();
+
+	/**
+	 * Set the weight of a rule (@c 1 by default, @c 0 to disable it).
+	 *
+	 * @return Whether the weight has been set.
+	 */
+	bool setRuleWeight(Rule* rule, double weight);
+
+	/**
+	 * Add an observable as a unary operator of the module whose
+	 * application to the states reduces to a number.
+	 *
+	 * @return Whether the observable has been added.
+	 */
+	bool addObservable(Symbol* symbol);
+
+	/**
+	 * Set the steps where the observables are evaluated (only the
+	 * final step by default, while the step @c 0 is the initial state).
+	 */
+	void setObservationSteps(const std::vector<int> &steps);
+
+	/**
+	 * Execute the runs of the simulation (replacing the previous results).
+	 *
+	 * @param nrRuns Number of runs.
+	 * @param seed Seed of the random choices.
+	 *
+	 * @return Whether all runs have been completed (@c false if the
+	 * number of runs is negative).
+	 */
+	bool run(int nrRuns, long long seed = 0);
+
+	/**
+	 * Get the number of completed runs.
+	 */
+	int getNrRuns() const;
+
+	/**
+	 * Get the number of observables.
+	 */
+	int getNrObservables() const;
+
+	/**
+	 * Get the steps where the observables are evaluated.
+	 */
+	std::vector<int> getObservationSteps() const;
+
+	/**
+	 * Get the values of an observable by run and observation step
+	 * (in row-major order), or an empty vector if there is no such
+	 * observable.
+	 */
+	std::vector<double> getObservations(int observable) const;
+
+	/**
+	 * Get the mean of an observable over the runs at each observation step
+	 * (or an empty vector if there is no such observable).
+	 */
+	std::vector<double> getMeans(int observable) const;
+
+	/**
+	 * Get the sample variance of an observable over the runs at each
+	 * observation step (or an empty vector if there is no such observable).
+	 */
+	std::vector<double> getVariances(int observable) const;
+
+	/**
+	 * Get the number of rule rewrites applied by each run.
+	 */
+	std::vector<int> getRunLengths() const;
+
+	/**
+	 * Get the total number of rewrites in all runs.
+	 */
+	long long getRewriteCount() const;
+
+private:
+	/**
+	 * Check whether an observable index is valid (with a warning otherwise).
+	 */
+	bool checkObservable(int observable) const;
+
+	EnginePool* pool;
+	VisibleModule* vmod;
+	std::string initialState;
+	int maxSteps;
+
+	std::vector<double> ruleWeights;
+	std::vector<Symbol*> observables;
+	std::vector<int> steps;
+
+	// Values of each observable by run and step
+	std::vector<std::vector<double>> observations;
+	std::vector<int> runLengths;
+	long long nrRewrites = 0;
+};
+
+inline int
+Simulation::getNrRuns() const {
+	return runLengths.size();
+}
+
+inline int
+Simulation::getNrObservables() const {
+	return observables.size();
+}
+
+inline std::vector<int>
+Simulation::getObservationSteps() const {
+	return steps;
+}
+
+inline std::vector<int>
+Simulation::getRunLengths() const {
+	return runLengths;
+}
+
+inline long long
+Simulation::getRewriteCount() const {
+	return nrRewrites;
+}
+
+#endif // SIMULATION_HH
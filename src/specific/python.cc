@@ -4,10 +4,22 @@
 
 // Basic types
 
+PyObject* convert2Py(int value) {
+	return PyLong_FromLong(value);
+}
+
 PyObject* convert2Py(long value) {
 	return PyLong_FromLong(value);
 }
 
+PyObject* convert2Py(long long value) {
+	return PyLong_FromLongLong(value);
+}
+
+PyObject* convert2Py(double value) {
+	return PyFloat_FromDouble(value);
+}
+
 PyObject* convert2Py(const char* value) {
 	return SWIG_FromCharPtrAndSize(value, strlen(value));
 }
@@ -34,6 +46,47 @@ PyObject* convert2Py(EasySubstitution* value) {
 		                  SWIGTYPE_p_EasySubstitution, SWIG_POINTER_OWN);
 }
 
+// Solutions are converted to tuples (term, substitution, unifier, stateNr, rewrites)
+PyObject* convert2Py(const SearchSolution &solution) {
+	PyObject* items[] = {
+		convert2Py(solution.term),
+		convert2Py(solution.substitution),
+		convert2Py(solution.unifier),
+		convert2Py(solution.stateNr),
+		convert2Py(solution.rewrites),
+	};
+
+	PyObject* tuple = PyTuple_Pack(5, items[0], items[1], items[2], items[3], items[4]);
+
+	for (PyObject* item : items)
+		Py_XDECREF(item);
+
+	return tuple;
+}
+
+// Paths are converted to lists interleaving terms and rules or transitions
+PyObject* convert2Py(const std::vector<PathStep> &path) {
+	PyObject* list = PyList_New(0);
+
+	for (const PathStep &step : path) {
+		if (PyList_GET_SIZE(list) > 0) {
+			PyObject* arc = step.transition != nullptr
+				? SWIG_NewPointerObj(SWIG_as_voidptr(step.transition),
+				                     SWIGTYPE_p_StrategyTransitionGraph__Transition, 0)
+				: SWIG_NewPointerObj(SWIG_as_voidptr(step.rule), SWIGTYPE_p_Rule, 0);
+
+			PyList_Append(list, arc);
+			Py_XDECREF(arc);
+		}
+
+		PyObject* term = convert2Py(step.term);
+		PyList_Append(list, term);
+		Py_XDECREF(term);
+	}
+
+	return list;
+}
+
 // Structured objects
 
 template<typename T>
@@ -0,0 +1,169 @@
+/**
+ * @file state_store.cc
+ *
+ * Append-only stores of serialized states in memory or on disk.
+ */
+
+#include "macros.hh"
+#include "core.hh"
+#include "interface.hh"
+#include "mixfix.hh"
+
+#include "state_store.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifndef _WIN32
+// Initial size of the file (it doubles when full)
+const size_t INITIAL_FILE_SIZE = size_t(1) << 24;
+#endif
+
+StateStore::StateStore(bool onDisk, const string &directory) {
+	if (!onDisk)
+		return;
+
+#ifdef _WIN32
+	IssueWarning("disk-backed stores are not supported in this platform, states will be kept in memory.");
+#else
+	string dirname = directory;
+
+	if (dirname.empty()) {
+		const char* tmpdir = getenv("TMPDIR");
+		dirname = tmpdir != nullptr ? tmpdir : "/tmp";
+	}
+
+	string path = dirname + "/maude-states-XXXXXX";
+	fd = mkstemp(path.data());
+
+	if (fd < 0) {
+		IssueWarning("cannot create a state file in " << QUOTE(dirname) << ": "
+			<< strerror(errno) << ", states will be kept in memory.");
+		return;
+	}
+
+	// The file is only reachable through the descriptor
+	unlink(path.c_str());
+
+	if (!reserve(INITIAL_FILE_SIZE)) {
+		IssueWarning("cannot map the state file: " << strerror(errno)
+			<< ", states will be kept in memory.");
+		close(fd);
+		fd = -1;
+	}
+#endif
+}
+
+StateStore::StateStore(StateStore &&other)
+ : memory(std::move(other.memory)),
+   fd(other.fd),
+   mapped(other.mapped),
+   capacity(other.capacity),
+   used(other.used),
+   offsets(std::move(other.offsets))
+{
+	other.fd = -1;
+	other.mapped = nullptr;
+	other.capacity = 0;
+	other.used = 0;
+}
+
+StateStore::~StateStore() {
+#ifndef _WIN32
+	if (mapped != nullptr)
+		munmap(mapped, capacity);
+	if (fd >= 0)
+		close(fd);
+#endif
+}
+
+bool
+StateStore::reserve(size_t bytes) {
+#ifndef _WIN32
+	if (bytes <= capacity)
+		return true;
+
+	size_t newCapacity = max(capacity, INITIAL_FILE_SIZE);
+
+	while (newCapacity < bytes)
+		newCapacity *= 2;
+
+	// The blocks are allocated now (instead of growing a sparse file),
+	// so that a full disk is reported here and not as a signal when
+	// writing through the mapping
+#ifdef __APPLE__
+	fstore_t store = {F_ALLOCATEALL, F_PEOFPOSMODE, 0, off_t(newCapacity - capacity), 0};
+
+	if (fcntl(fd, F_PREALLOCATE, &store) != 0 || ftruncate(fd, newCapacity) != 0)
+		return false;
+#else
+	if (int error = posix_fallocate(fd, capacity, newCapacity - capacity)) {
+		errno = error;
+		return false;
+	}
+#endif
+
+	// The file is mapped again with its new size, keeping the old
+	// mapping if that fails
+	void* address = mmap(nullptr, newCapacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+	if (address == MAP_FAILED)
+		return false;
+
+	if (mapped != nullptr)
+		munmap(mapped, capacity);
+
+	mapped = static_cast<char*>(address);
+	capacity = newCapacity;
+#endif
+	return true;
+}
+
+const char*
+StateStore::data() const {
+	return fd >= 0 ? mapped : memory.data();
+}
+
+size_t
+StateStore::append(const string &record) {
+	if (fd >= 0) {
+		if (!reserve(used + record.size())) {
+			IssueWarning("cannot extend the state file: " << strerror(errno) << ".");
+			return NONE;
+		}
+
+		memcpy(mapped + used, record.data(), record.size());
+	}
+	else
+		memory.insert(memory.end(), record.begin(), record.end());
+
+	offsets.push_back(used);
+	used += record.size();
+
+	return offsets.size() - 1;
+}
+
+string
+StateStore::get(size_t index) const {
+	size_t start = offsets[index];
+	size_t end = index + 1 < offsets.size() ? offsets[index + 1] : used;
+
+	return string(data() + start, end - start);
+}
+
+void
+StateStore::clear() {
+	memory.clear();
+	offsets.clear();
+	used = 0;
+}
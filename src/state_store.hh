@@ -0,0 +1,96 @@
+/**
+ * @file state_store.hh
+ *
+ * Append-only stores of serialized states in memory or on disk.
+ */
+
+#ifndef STATE_STORE_HH
+#define STATE_STORE_HH
+
+#include <string>
+#include <vector>
+
+/**
+ * Append-only sequence of byte records, kept in memory or in a
+ * memory-mapped temporary file that grows as needed.
+ *
+ * The file is removed from its directory as soon as it is created,
+ * so it disappears when the store is destroyed or the process ends.
+ * Only the offsets of the records are kept in memory.
+ */
+class StateStore {
+public:
+	/**
+	 * Create a store.
+	 *
+	 * @param onDisk Whether the records are kept in a file (if the file
+	 * cannot be created, they are kept in memory with a warning).
+	 * @param directory Directory of the file (the temporary directory
+	 * of the system if empty).
+	 */
+	StateStore(bool onDisk = false, const std::string &directory = "");
+	~StateStore();
+
+	StateStore(const StateStore &) = delete;
+	StateStore(StateStore &&other);
+
+	/**
+	 * Append a record.
+	 *
+	 * @return Its index or @c NONE if the file cannot be extended.
+	 */
+	size_t append(const std::string &record);
+
+	/**
+	 * Get a copy of a record.
+	 */
+	std::string get(size_t index) const;
+
+	/**
+	 * Get the number of records.
+	 */
+	size_t size() const;
+
+	/**
+	 * Get the number of bytes of the records.
+	 */
+	size_t getByteSize() const;
+
+	/**
+	 * Whether the records are kept on disk.
+	 */
+	bool isOnDisk() const;
+
+	/**
+	 * Remove all records (the file keeps its size for reuse).
+	 */
+	void clear();
+
+private:
+	bool reserve(size_t bytes);
+	const char* data() const;
+
+	std::vector<char> memory;
+	int fd = -1;
+	char* mapped = nullptr;
+	size_t capacity = 0;
+	size_t used = 0;
+	std::vector<size_t> offsets;
+};
+
+inline size_t
+StateStore::size() const {
+	return offsets.size();
+}
+
+inline size_t
+StateStore::getByteSize() const {
+	return used;
+}
+
+inline bool
+StateStore::isOnDisk() const {
+	return fd >= 0;
+}
+
+#endif // STATE_STORE_HH
@@ -0,0 +1,248 @@
+/**
+ * @file statistical_checking.cc
+ *
+ * Statistical model checking of temporal properties on random
+ * executions distributed among the workers of an engine pool.
+ */
+
+#include "macros.hh"
+#include "core.hh"
+#include "interface.hh"
+#include "mixfix.hh"
+#include "higher.hh"
+
+#include "visibleModule.hh"
+#include "userLevelRewritingContext.hh"
+#include "dagRoot.hh"
+
+#include "statistical_checking.hh"
+#include "simulation.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <memory>
+
+using namespace std;
+
+//
+// Worker side
+//
+
+namespace {
+
+bool
+checkJob(PoolMessage &request, PoolMessage &reply) {
+	unique_ptr<EasyTerm> initial(request.getTerm());
+
+	if (initial == nullptr)
+		return false;
+
+	VisibleModule* vmod = safeCast(VisibleModule*, initial->symbol()->getModule());
+	unique_ptr<EasyTerm> formulaTerm(request.getTerm(vmod));
+
+	if (formulaTerm == nullptr)
+		return false;
+
+	int maxSteps = request.getInt();
+	uint64_t seed = request.getInt();
+	long long firstSample = request.getInt();
+	long long nrSamples = request.getInt();
+
+	vector<double> ruleWeights(request.getInt());
+
+	for (double &weight : ruleWeights)
+		weight = request.getDouble();
+
+	RandomStepper stepper(ruleWeights);
+	UserLevelRewritingContext context(initial->getDag());
+	context.reduce();
+
+	TraceFormula formula(&context, formulaTerm->getDag());
+
+	if (!formula.isValid())
+		return false;
+
+	for (long long sample = firstSample; sample < firstSample + nrSamples; sample++) {
+		stepper.seed(seed, sample);
+
+		// The roots protect the states of the trace
+		deque<DagRoot> roots;
+		vector<DagNode*> trace = {context.root()};
+
+		while (int(trace.size()) <= maxSteps && !UserLevelRewritingContext::aborted()) {
+			DagNode* successor = stepper.step(trace.back(), &context);
+
+			if (successor == nullptr)
+				break;
+
+			roots.emplace_back(successor);
+			trace.push_back(successor);
+		}
+
+		reply.putInt(formula.check(trace));
+
+		if (UserLevelRewritingContext::aborted())
+			return false;
+	}
+
+	reply.putInt(context.getTotalCount());
+	return true;
+}
+
+[[maybe_unused]] bool checkingJobsRegistered =
+	EnginePool::registerJob(EnginePool::SMC_JOB, checkJob);
+
+}
+
+//
+// Parent side
+//
+
+StatisticalChecker::StatisticalChecker(EnginePool* pool, EasyTerm* initial,
+                                       EasyTerm* formula, int maxSteps)
+ : pool(pool),
+   vmod(safeCast(VisibleModule*, initial->symbol()->getModule())),
+   initialState(initial->serialize()),
+   maxSteps(max(maxSteps, 0))
+{
+	// Rules are referenced by the checker
+	vmod->protect();
+
+	if (formula->symbol()->getModule() != vmod) {
+		IssueWarning("the formula does not belong to the module of the initial term.");
+		return;
+	}
+
+	// The formula is prepared here to report errors early
+	UserLevelRewritingContext context(initial->getDag());
+	valid = TraceFormula(&context, formula->getDag()).isValid();
+
+	if (!valid) {
+		IssueWarning("module is not prepared for model checking (the model checker module is not included).");
+		return;
+	}
+
+	this->formula = formula->serialize();
+}
+
+StatisticalChecker::~StatisticalChecker() {
+	(void) vmod->unprotect();
+}
+
+bool
+StatisticalChecker::setRuleWeight(Rule* rule, double weight) {
+	return RandomStepper::setWeight(ruleWeights, vmod, rule, weight);
+}
+
+bool
+StatisticalChecker::sample(long long firstSample, long long nrSamples, long long seed,
+                           vector<bool> &results) {
+	// Samples are split in more jobs than workers to balance the load
+	long long nrJobs = min(nrSamples, max(1LL, (long long) pool->getNrWorkers()) * 4);
+	vector<PoolMessage> requests(nrJobs);
+
+	for (long long i = 0; i < nrJobs; i++) {
+		PoolMessage &request = requests[i];
+		request.putInt(EnginePool::SMC_JOB);
+		request.putString(initialState);
+		request.putString(formula);
+		request.putInt(maxSteps);
+		request.putInt(seed);
+		request.putInt(firstSample + nrSamples * i / nrJobs);
+		request.putInt(nrSamples * (i + 1) / nrJobs - nrSamples * i / nrJobs);
+
+		request.putInt(ruleWeights.size());
+		for (double weight : ruleWeights)
+			request.putDouble(weight);
+	}
+
+	vector<PoolMessage> replies = pool->execute(requests);
+
+	for (long long i = 0; i < nrJobs; i++) {
+		PoolMessage &reply = replies[i];
+
+		if (reply.getInt() != EnginePool::JOB_SUCCEEDED) {
+			IssueWarning("the statistical model checking has been interrupted.");
+			return false;
+		}
+
+		long long nrJobSamples = nrSamples * (i + 1) / nrJobs - nrSamples * i / nrJobs;
+
+		for (long long j = 0; j < nrJobSamples; j++)
+			results.push_back(reply.getInt() != 0);
+
+		nrRewrites += reply.getInt();
+	}
+
+	return true;
+}
+
+double
+StatisticalChecker::estimate(double epsilon, double delta, long long seed) {
+	nrSamples = nrSatisfied = nrRewrites = 0;
+
+	if (!valid || epsilon <= 0.0 || delta <= 0.0 || delta >= 1.0)
+		return -1.0;
+
+	// Okamoto's bound for the absolute error of the estimation
+	long long nrNeeded = ceil(log(2.0 / delta) / (2.0 * epsilon * epsilon));
+	vector<bool> results;
+
+	if (!sample(0, nrNeeded, seed, results))
+		return -1.0;
+
+	nrSamples = nrNeeded;
+	nrSatisfied = count(results.begin(), results.end(), true);
+
+	return getProbability();
+}
+
+ProbabilityTest
+StatisticalChecker::test(double threshold, double indifference, double alpha,
+                         double beta, long long seed, long long maxSamples) {
+	nrSamples = nrSatisfied = nrRewrites = 0;
+
+	if (!valid)
+		return TEST_FAILED;
+
+	// Hypotheses p >= p0 and p <= p1 separated by the indifference region
+	double p0 = min(threshold + indifference, 1.0 - 1e-9);
+	double p1 = max(threshold - indifference, 1e-9);
+
+	if (p1 >= p0 || alpha <= 0.0 || beta <= 0.0 || alpha + beta >= 1.0) {
+		IssueWarning("invalid parameters for the sequential probability ratio test.");
+		return TEST_FAILED;
+	}
+
+	double logAccept1 = log((1.0 - beta) / alpha);
+	double logAccept0 = log(beta / (1.0 - alpha));
+	double logSatisfied = log(p1 / p0);
+	double logViolated = log((1.0 - p1) / (1.0 - p0));
+	double ratio = 0.0;
+
+	// Samples are obtained in batches, but they are consumed in order,
+	// so the test stops at the same sample for any number of workers
+	long long batchSize = max(1LL, (long long) pool->getNrWorkers()) * 32;
+
+	while (maxSamples < 0 || nrSamples < maxSamples) {
+		long long nrBatch = maxSamples < 0 ? batchSize : min(batchSize, maxSamples - nrSamples);
+		vector<bool> results;
+
+		if (!sample(nrSamples, nrBatch, seed, results))
+			return TEST_FAILED;
+
+		for (bool satisfied : results) {
+			nrSamples++;
+			nrSatisfied += satisfied;
+			ratio += satisfied ? logSatisfied : logViolated;
+
+			if (ratio >= logAccept1)
+				return BELOW_THRESHOLD;
+			else if (ratio <= logAccept0)
+				return ABOVE_THRESHOLD;
+		}
+	}
+
+	return TEST_UNDECIDED;
+}
@@ -0,0 +1,209 @@
+/**
+ * @file statistical_checking.hh
+ *
+ * Statistical model checking of temporal properties on random
+ * executions distributed among the workers of an engine pool.
+ */
+
+#ifndef STATISTICAL_CHECKING_HH
+#define STATISTICAL_CHECKING_HH
+
+#include "engine_pool.hh"
+
+#include <string>
+#include <vector>
+
+class LogicFormula;
+struct TraceSystemAutomaton;
+
+/**
+ * LTL formula evaluated on finite traces, whose last state is taken to
+ * repeat forever (as the model checker does with deadlocked states).
+ *
+ * Atomic propositions are evaluated with the @c _|=_ operator of the
+ * module, as in the model checker.
+ */
+class TraceFormula {
+public:
+	/**
+	 * Prepare a formula.
+	 *
+	 * @param context Context where the rewrites are counted, whose
+	 * root belongs to the module of the formula.
+	 * @param formula Term of sort @c Formula.
+	 */
+	TraceFormula(RewritingContext* context, DagNode* formula);
+	~TraceFormula();
+
+	/**
+	 * Whether the module is prepared for model checking.
+	 */
+	bool isValid() const;
+
+	/**
+	 * Check whether the formula holds on a trace.
+	 *
+	 * @param trace Reduced states of the trace (that must be protected
+	 * from garbage collection by the caller).
+	 */
+	bool check(const std::vector<DagNode*> &trace);
+
+private:
+	TraceSystemAutomaton* system;
+	LogicFormula* formula;
+	int top;
+	bool valid;
+};
+
+inline bool
+TraceFormula::isValid() const {
+	return valid;
+}
+
+/**
+ * Outcome of a sequential probability ratio test.
+ */
+enum ProbabilityTest {
+	ABOVE_THRESHOLD,	///< The probability is at least the threshold
+	BELOW_THRESHOLD,	///< The probability is below the threshold
+	TEST_UNDECIDED,		///< The maximum number of samples has been reached
+	TEST_FAILED,		///< The samples could not be obtained
+};
+
+/**
+ * Statistical model checker that evaluates a temporal formula on random
+ * executions of bounded length from an initial term.
+ *
+ * Executions are sampled as in a simulation, choosing at every step a
+ * rule rewrite with probability proportional to the weight of its rule.
+ * The LTL formula is evaluated on the sampled trace, whose last state is
+ * taken to repeat forever, so the bound on the number of steps is the
+ * bound of the temporal operators. Samples are distributed among the
+ * workers of the pool, each with its own generator seeded by the seed
+ * and the sample number.
+ */
+class StatisticalChecker {
+public:
+	/**
+	 * Create a statistical model checker.
+	 *
+	 * @param pool Engine pool (that must outlive the checker).
+	 * @param initial Initial term (it is not modified).
+	 * @param formula Term of sort @c Formula in the module of the initial term.
+	 * @param maxSteps Maximum number of rule rewrites per execution.
+	 */
+	StatisticalChecker(EnginePool* pool, EasyTerm* initial, EasyTerm* formula, int maxSteps);
+	~StatisticalChecker();
+
+	/**
+	 * Whether the module is prepared for model checking.
+	 */
+	bool isValid() const;
+
+	/**
+	 * Set the weight of a rule (@c 1 by default, @c 0 to disable it).
+	 *
+	 * @return Whether the weight has been set.
+	 */
+	bool setRuleWeight(Rule* rule, double weight);
+
+	/**
+	 * Estimate the probability that the formula holds, with a number of
+	 * samples given by the Chernoff-Hoeffding bound.
+	 *
+	 * @param epsilon Maximum distance to the actual probability.
+	 * @param delta Probability that the distance exceeds @c epsilon.
+	 * @param seed Seed of the random choices.
+	 *
+	 * @return The estimated probability or @c -1 if the samples could
+	 * not be obtained.
+	 */
+	double estimate(double epsilon = 0.01, double delta = 0.05, long long seed = 0);
+
+	/**
+	 * Test whether the probability that the formula holds is at least
+	 * a threshold with Wald's sequential probability ratio test.
+	 *
+	 * @param threshold Probability threshold.
+	 * @param indifference Half-width of the indifference region around
+	 * the threshold.
+	 * @param alpha Probability of wrongly concluding that the probability
+	 * is below the threshold.
+	 * @param beta Probability of wrongly concluding that the probability
+	 * is above the threshold.
+	 * @param seed Seed of the random choices.
+	 * @param maxSamples Maximum number of samples (@c -1 for no bound).
+	 */
+	ProbabilityTest test(double threshold, double indifference = 0.01, double alpha = 0.05,
+	                     double beta = 0.05, long long seed = 0, long long maxSamples = -1);
+
+	/**
+	 * Get the number of samples used by the last estimation or test.
+	 */
+	long long getNrSamples() const;
+
+	/**
+	 * Get the number of samples where the formula holds.
+	 */
+	long long getNrSatisfied() const;
+
+	/**
+	 * Get the proportion of samples where the formula holds.
+	 */
+	double getProbability() const;
+
+	/**
+	 * Get the total number of rewrites in all samples.
+	 */
+	long long getRewriteCount() const;
+
+private:
+	/**
+	 * Obtain the given samples, appending whether the formula holds
+	 * on each of them to the results.
+	 *
+	 * @return Whether all samples have been obtained.
+	 */
+	bool sample(long long firstSample, long long nrSamples, long long seed,
+	            std::vector<bool> &results);
+
+	EnginePool* pool;
+	VisibleModule* vmod;
+	std::string initialState;
+	std::string formula;
+	int maxSteps;
+	bool valid = false;
+
+	std::vector<double> ruleWeights;
+
+	long long nrSamples = 0;
+	long long nrSatisfied = 0;
+	long long nrRewrites = 0;
+};
+
+inline bool
+StatisticalChecker::isValid() const {
+	return valid;
+}
+
+inline long long
+StatisticalChecker::getNrSamples() const {
+	return nrSamples;
+}
+
+inline long long
+StatisticalChecker::getNrSatisfied() const {
+	return nrSatisfied;
+}
+
+inline double
+StatisticalChecker::getProbability() const {
+	return nrSamples > 0 ? double(nrSatisfied) / nrSamples : 0.0;
+}
+
+inline long long
+StatisticalChecker::getRewriteCount() const {
+	return nrRewrites;
+}
+
+#endif // STATISTICAL_CHECKING_HH
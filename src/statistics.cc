@@ -0,0 +1,66 @@
+/**
+ * @file statistics.cc
+ *
+ * Statistics of the Maude operations.
+ */
+
+#include "statistics.hh"
+
+#include "macros.hh"
+#include "vector.hh"
+#include "core.hh"
+#include "rootContainer.hh"
+#include "rewritingContext.hh"
+
+using namespace std;
+
+//
+// Garbage collections are counted by a root container, whose
+// markReachableNodes method is called once per collection
+//
+
+class GcCounter : private RootContainer {
+public:
+	GcCounter() { link(); }
+
+	long long count = 0;
+
+private:
+	void markReachableNodes() { count++; }
+};
+
+long long
+StatsRecorder::getGcCount() {
+	static GcCounter counter;
+	return counter.count;
+}
+
+StatsRecorder::StatsRecorder()
+ : cpuStart(clock()), realStart(Clock::now()), gcStart(getGcCount())
+{
+}
+
+RewriteStats
+StatsRecorder::fromContext(const RewritingContext* context) {
+	if (context == nullptr)
+		return {0, 0, 0, 0, 0, 0, 0, 0.0, 0.0};
+
+	return {context->getTotalCount(),
+		context->getEqCount(),
+		context->getRlCount(),
+		context->getMbCount(),
+		context->getNarrowingCount(),
+		context->getVariantNarrowingCount(),
+		0, 0.0, 0.0};
+}
+
+RewriteStats
+StatsRecorder::finish(const RewritingContext* context) const {
+	RewriteStats stats = fromContext(context);
+
+	stats.gcRuns = getGcCount() - gcStart;
+	stats.cpuTime = double(clock() - cpuStart) / CLOCKS_PER_SEC;
+	stats.realTime = chrono::duration<double>(Clock::now() - realStart).count();
+
+	return stats;
+}
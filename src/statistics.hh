@@ -0,0 +1,63 @@
+/**
+ * @file statistics.hh
+ *
+ * Statistics of the Maude operations.
+ */
+
+#ifndef STATISTICS_HH
+#define STATISTICS_HH
+
+#include <chrono>
+#include <ctime>
+
+class RewritingContext;
+
+/**
+ * Statistics of a rewriting operation.
+ */
+struct RewriteStats {
+	long long total;		///< Total number of rewrites.
+	long long equational;		///< Number of equational rewrites (including built-in ones).
+	long long rule;			///< Number of rule rewrites.
+	long long membership;		///< Number of membership axiom applications.
+	long long narrowing;		///< Number of narrowing steps.
+	long long variantNarrowing;	///< Number of variant narrowing steps.
+	long long gcRuns;		///< Number of garbage collections.
+	double cpuTime;			///< Processor time in seconds.
+	double realTime;		///< Wall-clock time in seconds.
+};
+
+/**
+ * Measures the statistics of an operation since its construction.
+ */
+class StatsRecorder {
+public:
+	StatsRecorder();
+
+	/**
+	 * Get the statistics of the operation.
+	 *
+	 * @param context The rewriting context of the operation
+	 * (or null if no rewrites have been done).
+	 */
+	RewriteStats finish(const RewritingContext* context) const;
+
+	/**
+	 * Get the rewrite counts of a context (times are zero).
+	 */
+	static RewriteStats fromContext(const RewritingContext* context);
+
+	/**
+	 * Get the number of garbage collections since the first call.
+	 */
+	static long long getGcCount();
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	std::clock_t cpuStart;
+	Clock::time_point realStart;
+	long long gcStart;
+};
+
+#endif // STATISTICS_HH
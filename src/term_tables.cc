@@ -0,0 +1,276 @@
+/**
+ * @file term_tables.cc
+ *
+ * Tables of terms indexed by their structure.
+ */
+
+#include "term_tables.hh"
+
+#include "dagNode.hh"
+#include "visibleModule.hh"
+
+#include <algorithm>
+
+using namespace std;
+
+//
+// Base table
+//
+
+TermTable::TermTable(VisibleModule* vmod)
+ : vmod(vmod)
+{
+	vmod->protect();
+	link();
+}
+
+TermTable::~TermTable() {
+	unlink();
+	(void) vmod->unprotect();
+}
+
+void
+TermTable::markReachableNodes() {
+	for (DagNode* node : nodes)
+		node->mark();
+}
+
+DagNode*
+TermTable::getDag(EasyTerm* term) const {
+	DagNode* dag = term->getDag();
+
+	if (dag->symbol()->getModule() != vmod) {
+		IssueWarning("the term " << QUOTE(dag) << " does not belong to module "
+			<< QUOTE(Token::name(vmod->id())) << ".");
+		return nullptr;
+	}
+
+	return dag;
+}
+
+int
+TermTable::lookup(DagNode* dag, size_t hash) const {
+	auto [begin, end] = index.equal_range(hash);
+
+	for (auto it = begin; it != end; ++it)
+		if (nodes[it->second] == dag || nodes[it->second]->equal(dag))
+			return it->second;
+
+	return -1;
+}
+
+int
+TermTable::lookup(DagNode* dag) const {
+	return lookup(dag, dag->getHashValue());
+}
+
+pair<int, bool>
+TermTable::insert(DagNode* dag) {
+	size_t hash = dag->getHashValue();
+	int position = lookup(dag, hash);
+
+	if (position >= 0)
+		return {position, false};
+
+	// Unreduced nodes may be overwritten in place by a later
+	// reduction, so a copy is kept instead
+	if (!dag->isReduced())
+		dag = dag->copyAll();
+
+	position = nodes.size();
+	nodes.push_back(dag);
+	hashes.push_back(hash);
+	index.insert({hash, position});
+
+	return {position, true};
+}
+
+EasyTerm*
+TermTable::makeTerm(int position) const {
+	// The stored DAG must not be modified by the caller
+	DagNode* dag = nodes[position];
+	return new EasyTerm(dag->isReduced() ? dag : dag->copyAll());
+}
+
+void
+TermTable::clear() {
+	nodes.clear();
+	hashes.clear();
+	index.clear();
+}
+
+//
+// Interner
+//
+
+TermInterner::TermInterner(VisibleModule* vmod)
+ : TermTable(vmod)
+{
+}
+
+int
+TermInterner::intern(EasyTerm* term) {
+	DagNode* dag = getDag(term);
+	return dag != nullptr ? insert(dag).first : -1;
+}
+
+vector<int>
+TermInterner::internMany(const vector<EasyTerm*> &terms) {
+	vector<int> handles;
+	handles.reserve(terms.size());
+
+	for (EasyTerm* term : terms)
+		handles.push_back(intern(term));
+
+	return handles;
+}
+
+int
+TermInterner::find(EasyTerm* term) {
+	DagNode* dag = getDag(term);
+	return dag != nullptr ? lookup(dag) : -1;
+}
+
+EasyTerm*
+TermInterner::getTerm(int handle) const {
+	if (handle < 0 || handle >= size())
+		return nullptr;
+
+	return makeTerm(handle);
+}
+
+size_t
+TermInterner::getHash(int handle) const {
+	if (handle < 0 || handle >= size())
+		return 0;
+
+	return hashes[handle];
+}
+
+//
+// Set
+//
+
+EasyTermSet::EasyTermSet(VisibleModule* vmod)
+ : TermTable(vmod)
+{
+}
+
+bool
+EasyTermSet::insert(EasyTerm* term) {
+	DagNode* dag = getDag(term);
+	return dag != nullptr && TermTable::insert(dag).second;
+}
+
+bool
+EasyTermSet::contains(EasyTerm* term) {
+	DagNode* dag = getDag(term);
+	return dag != nullptr && lookup(dag) >= 0;
+}
+
+vector<int>
+EasyTermSet::insertMany(const vector<EasyTerm*> &terms) {
+	vector<int> inserted;
+	inserted.reserve(terms.size());
+
+	for (EasyTerm* term : terms)
+		inserted.push_back(insert(term));
+
+	return inserted;
+}
+
+vector<int>
+EasyTermSet::containsMany(const vector<EasyTerm*> &terms) {
+	vector<int> found;
+	found.reserve(terms.size());
+
+	for (EasyTerm* term : terms)
+		found.push_back(contains(term));
+
+	return found;
+}
+
+vector<EasyTerm*>
+EasyTermSet::getTerms() const {
+	vector<EasyTerm*> terms;
+	terms.reserve(nodes.size());
+
+	for (size_t i = 0; i < nodes.size(); ++i)
+		terms.push_back(makeTerm(i));
+
+	return terms;
+}
+
+//
+// Map
+//
+
+EasyTermMap::EasyTermMap(VisibleModule* vmod)
+ : TermTable(vmod)
+{
+}
+
+void
+EasyTermMap::set(EasyTerm* term, int value) {
+	DagNode* dag = getDag(term);
+
+	if (dag == nullptr)
+		return;
+
+	auto [position, inserted] = insert(dag);
+
+	if (inserted)
+		values.push_back(value);
+	else
+		values[position] = value;
+}
+
+int
+EasyTermMap::get(EasyTerm* term, int defaultValue) {
+	DagNode* dag = getDag(term);
+	int position = dag != nullptr ? lookup(dag) : -1;
+
+	return position >= 0 ? values[position] : defaultValue;
+}
+
+bool
+EasyTermMap::contains(EasyTerm* term) {
+	DagNode* dag = getDag(term);
+	return dag != nullptr && lookup(dag) >= 0;
+}
+
+void
+EasyTermMap::setMany(const vector<EasyTerm*> &terms, const vector<int> &values) {
+	size_t nrEntries = min(terms.size(), values.size());
+
+	for (size_t i = 0; i < nrEntries; ++i)
+		set(terms[i], values[i]);
+}
+
+vector<int>
+EasyTermMap::getMany(const vector<EasyTerm*> &terms, int defaultValue) {
+	vector<int> result;
+	result.reserve(terms.size());
+
+	for (EasyTerm* term : terms)
+		result.push_back(get(term, defaultValue));
+
+	return result;
+}
+
+vector<EasyTerm*>
+EasyTermMap::getKeys() const {
+	vector<EasyTerm*> keys;
+	keys.reserve(nodes.size());
+
+	for (size_t i = 0; i < nodes.size(); ++i)
+		keys.push_back(makeTerm(i));
+
+	return keys;
+}
+
+void
+EasyTermMap::clear() {
+	TermTable::clear();
+	values.clear();
+}
@@ -0,0 +1,228 @@
+/**
+ * @file term_tables.hh
+ *
+ * Tables of terms indexed by their structure.
+ */
+
+#ifndef TERM_TABLES_HH
+#define TERM_TABLES_HH
+
+#include "easyTerm.hh"
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Base class of the tables of terms of a module, which are stored as DAGs
+ * with their hash value and compared with the Maude DAG equality.
+ *
+ * Stored terms are kept as reduced DAGs or as private copies, so later
+ * changes to the original terms do not affect them.
+ */
+class TermTable : public RootContainer {
+public:
+	/**
+	 * Get the number of distinct terms in the table.
+	 */
+	int size() const;
+
+	/**
+	 * Get the module of the table.
+	 */
+	VisibleModule* getModule() const;
+
+protected:
+	TermTable(VisibleModule* vmod);
+	~TermTable();
+
+	/**
+	 * Get the DAG of a term, checking that it belongs to the module.
+	 *
+	 * @return The DAG or null if the term belongs to another module.
+	 */
+	DagNode* getDag(EasyTerm* term) const;
+
+	/**
+	 * Look up a DAG in the table.
+	 *
+	 * @return Its position in the table or @c -1 if not found.
+	 */
+	int lookup(DagNode* dag) const;
+
+	/**
+	 * Insert a DAG in the table if not already present.
+	 *
+	 * @return Its position in the table and whether it has been inserted.
+	 */
+	std::pair<int, bool> insert(DagNode* dag);
+
+	/**
+	 * Get a new term for the DAG at the given position.
+	 */
+	EasyTerm* makeTerm(int position) const;
+
+	/**
+	 * Remove all terms from the table.
+	 */
+	void clear();
+
+	std::vector<DagNode*> nodes;
+	std::vector<size_t> hashes;
+
+private:
+	void markReachableNodes();
+	int lookup(DagNode* dag, size_t hash) const;
+
+	VisibleModule* vmod;
+	std::unordered_multimap<size_t, int> index;
+};
+
+/**
+ * Table mapping structurally equal terms of a module to the same
+ * integer handle, so that equality becomes integer comparison.
+ *
+ * The hash value of each term is computed once when it is interned.
+ */
+class TermInterner : public TermTable {
+public:
+	TermInterner(VisibleModule* vmod);
+
+	/**
+	 * Get the handle of a term, inserting it if not already present.
+	 *
+	 * @return The handle or @c -1 if the term belongs to another module.
+	 */
+	int intern(EasyTerm* term);
+
+	/**
+	 * Intern many terms at once.
+	 */
+	std::vector<int> internMany(const std::vector<EasyTerm*> &terms);
+
+	/**
+	 * Get the handle of a term without inserting it.
+	 *
+	 * @return The handle or @c -1 if the term is not in the table.
+	 */
+	int find(EasyTerm* term);
+
+	/**
+	 * Get the canonical term for a handle (or null if the handle is not valid).
+	 */
+	EasyTerm* getTerm(int handle) const;
+
+	/**
+	 * Get the cached hash value of the term for a handle.
+	 */
+	size_t getHash(int handle) const;
+};
+
+/**
+ * Set of terms of a module.
+ */
+class EasyTermSet : public TermTable {
+public:
+	EasyTermSet(VisibleModule* vmod);
+
+	/**
+	 * Insert a term in the set.
+	 *
+	 * @return Whether the term was not already in the set.
+	 */
+	bool insert(EasyTerm* term);
+
+	/**
+	 * Check whether a term is in the set.
+	 */
+	bool contains(EasyTerm* term);
+
+	/**
+	 * Insert many terms at once.
+	 *
+	 * @return For each term, whether it was not already in the set.
+	 */
+	std::vector<int> insertMany(const std::vector<EasyTerm*> &terms);
+
+	/**
+	 * Check whether many terms are in the set.
+	 */
+	std::vector<int> containsMany(const std::vector<EasyTerm*> &terms);
+
+	/**
+	 * Get the terms in the set (in insertion order).
+	 */
+	std::vector<EasyTerm*> getTerms() const;
+
+	using TermTable::clear;
+};
+
+/**
+ * Map from terms of a module to integers.
+ */
+class EasyTermMap : public TermTable {
+public:
+	EasyTermMap(VisibleModule* vmod);
+
+	/**
+	 * Set the value associated to a term.
+	 */
+	void set(EasyTerm* term, int value);
+
+	/**
+	 * Get the value associated to a term.
+	 *
+	 * @param defaultValue Value returned if the term is not in the map.
+	 */
+	int get(EasyTerm* term, int defaultValue = -1);
+
+	/**
+	 * Check whether a term is in the map.
+	 */
+	bool contains(EasyTerm* term);
+
+	/**
+	 * Set the values associated to many terms at once.
+	 */
+	void setMany(const std::vector<EasyTerm*> &terms, const std::vector<int> &values);
+
+	/**
+	 * Get the values associated to many terms at once.
+	 */
+	std::vector<int> getMany(const std::vector<EasyTerm*> &terms, int defaultValue = -1);
+
+	/**
+	 * Get the keys of the map (in insertion order).
+	 */
+	std::vector<EasyTerm*> getKeys() const;
+
+	/**
+	 * Get the values of the map (in the same order as the keys).
+	 */
+	std::vector<int> getValues() const;
+
+	/**
+	 * Remove all entries from the map.
+	 */
+	void clear();
+
+private:
+	std::vector<int> values;
+};
+
+inline int
+TermTable::size() const {
+	return nodes.size();
+}
+
+inline VisibleModule*
+TermTable::getModule() const {
+	return vmod;
+}
+
+inline std::vector<int>
+EasyTermMap::getValues() const {
+	return values;
+}
+
+#endif // TERM_TABLES_HH
@@ -0,0 +1,204 @@
+/**
+ * @file trace_recorder.cc
+ *
+ * Native recorder of rewrite steps.
+ */
+
+#include "trace_recorder.hh"
+#include "search_monitor.hh"
+#include "maude_wrappers.hh"
+
+#include "dagNode.hh"
+#include "equation.hh"
+#include "rule.hh"
+#include "interpreter.hh"
+#include "global.hh"
+
+using namespace std;
+
+//
+// Recording context
+//
+
+RecordingRewritingContext::RecordingRewritingContext(DagNode* root)
+ : UserLevelRewritingContext(root)
+{
+}
+
+RewritingContext*
+RecordingRewritingContext::makeSubcontext(DagNode* root, int purpose) {
+	// Subcontexts (for conditions and the states of searches) must be
+	// recording contexts too, although they lose their link to the
+	// parent context, which is only used by the interpreter tracer
+	if (TraceRecorder::current != nullptr || SearchMonitor::isMonitoring())
+		return new RecordingRewritingContext(root);
+
+	return UserLevelRewritingContext::makeSubcontext(root, purpose);
+}
+
+void
+RecordingRewritingContext::tracePreEqRewrite(DagNode* redex, const Equation* equation, int type) {
+	UserLevelRewritingContext::tracePreEqRewrite(redex, equation, type);
+
+	if (TraceRecorder* recorder = TraceRecorder::current; recorder != nullptr && recorder->withEquations)
+		// The redex will be overwritten in place by the result,
+		// so a shallow copy of it is recorded
+		recorder->record(type == BUILTIN ? TraceRecorder::BUILTIN :
+		                 (type == MEMOIZED ? TraceRecorder::MEMOIZED : TraceRecorder::EQUATION),
+		                 equation, redex->makeClone());
+}
+
+void
+RecordingRewritingContext::tracePostEqRewrite(DagNode* replacement) {
+	UserLevelRewritingContext::tracePostEqRewrite(replacement);
+
+	if (TraceRecorder* recorder = TraceRecorder::current; recorder != nullptr && recorder->withEquations)
+		recorder->finish(replacement);
+}
+
+void
+RecordingRewritingContext::tracePreRuleRewrite(DagNode* redex, const Rule* rule) {
+	UserLevelRewritingContext::tracePreRuleRewrite(redex, rule);
+
+	if (TraceRecorder::current != nullptr)
+		TraceRecorder::current->record(TraceRecorder::RULE, rule, redex);
+
+	// Searches make progress by rule rewrites
+	if (SearchMonitor::current != nullptr)
+		SearchMonitor::current->check();
+}
+
+void
+RecordingRewritingContext::tracePostRuleRewrite(DagNode* replacement) {
+	UserLevelRewritingContext::tracePostRuleRewrite(replacement);
+
+	if (TraceRecorder::current != nullptr)
+		TraceRecorder::current->finish(replacement);
+}
+
+//
+// Trace recorder
+//
+
+TraceRecorder* TraceRecorder::current = nullptr;
+
+TraceRecorder::TraceRecorder(int capacity, bool withEquations)
+ : capacity(capacity > 0 ? capacity : 1), withEquations(withEquations)
+{
+	steps.reserve(this->capacity);
+	link();
+}
+
+TraceRecorder::~TraceRecorder() {
+	if (active)
+		deactivate();
+	unlink();
+}
+
+void
+TraceRecorder::activate() {
+	if (active)
+		return;
+
+	previous = current;
+	current = this;
+	active = true;
+
+	// Trace hooks are only called when tracing is enabled
+	UserLevelRewritingContext::setTraceStatus(true);
+}
+
+void
+TraceRecorder::deactivate() {
+	if (!active)
+		return;
+
+	current = previous;
+	active = false;
+
+	// Tracing is kept if required by the interpreter flags, by another
+	// recorder, by a search monitor or by a cancelled operation
+	refreshTraceStatus();
+}
+
+void
+TraceRecorder::record(StepKind kind, const PreEquation* statement, DagNode* redex) {
+	Step step = {kind, statement, redex, nullptr};
+
+	if (steps.size() < capacity)
+		steps.push_back(step);
+	else {
+		steps[first] = step;
+		first = (first + 1) % capacity;
+	}
+
+	total++;
+}
+
+void
+TraceRecorder::finish(DagNode* result) {
+	if (!steps.empty())
+		steps[(first + steps.size() - 1) % steps.size()].result = result;
+}
+
+const TraceRecorder::Step*
+TraceRecorder::at(int index) const {
+	if (index < 0 || size_t(index) >= steps.size())
+		return nullptr;
+
+	return &steps[(first + index) % steps.size()];
+}
+
+TraceRecorder::StepKind
+TraceRecorder::getKind(int index) const {
+	const Step* step = at(index);
+	return step != nullptr ? step->kind : NONE;
+}
+
+Equation*
+TraceRecorder::getEquation(int index) const {
+	const Step* step = at(index);
+
+	if (step == nullptr || step->kind != EQUATION)
+		return nullptr;
+
+	return const_cast<Equation*>(static_cast<const Equation*>(step->statement));
+}
+
+Rule*
+TraceRecorder::getRule(int index) const {
+	const Step* step = at(index);
+
+	if (step == nullptr || step->kind != RULE)
+		return nullptr;
+
+	return const_cast<Rule*>(static_cast<const Rule*>(step->statement));
+}
+
+EasyTerm*
+TraceRecorder::getRedex(int index) const {
+	const Step* step = at(index);
+	return step != nullptr ? new EasyTerm(step->redex) : nullptr;
+}
+
+EasyTerm*
+TraceRecorder::getResult(int index) const {
+	const Step* step = at(index);
+	return step != nullptr && step->result != nullptr ? new EasyTerm(step->result) : nullptr;
+}
+
+void
+TraceRecorder::clear() {
+	steps.clear();
+	first = 0;
+	total = 0;
+}
+
+void
+TraceRecorder::markReachableNodes() {
+	for (const Step &step : steps) {
+		step.redex->mark();
+		if (step.result != nullptr)
+			step.result->mark();
+	}
+}
@@ -0,0 +1,170 @@
+/**
+ * @file trace_recorder.hh
+ *
+ * Native recorder of rewrite steps.
+ */
+
+#ifndef TRACE_RECORDER_HH
+#define TRACE_RECORDER_HH
+
+#include "easyTerm.hh"
+#include "userLevelRewritingContext.hh"
+
+#include <vector>
+
+/**
+ * Rewriting context that reports its rewrites to the active trace
+ * recorder (if any). It is used by the operations of the bindings
+ * instead of its parent class.
+ */
+class RecordingRewritingContext : public UserLevelRewritingContext {
+public:
+	RecordingRewritingContext(DagNode* root);
+
+	RewritingContext* makeSubcontext(DagNode* root, int purpose);
+
+	void tracePreEqRewrite(DagNode* redex, const Equation* equation, int type);
+	void tracePostEqRewrite(DagNode* replacement);
+	void tracePreRuleRewrite(DagNode* redex, const Rule* rule);
+	void tracePostRuleRewrite(DagNode* replacement);
+};
+
+/**
+ * Recorder of the rewrite steps executed while it is active, which are
+ * kept in a ring buffer of fixed capacity (the oldest ones are dropped).
+ */
+class TraceRecorder : private RootContainer {
+public:
+	/**
+	 * Kinds of steps.
+	 */
+	enum StepKind {
+		EQUATION,	///< Application of an equation.
+		BUILTIN,	///< Built-in equational rewrite (without equation).
+		MEMOIZED,	///< Equational rewrite using the memo table.
+		RULE,		///< Application of a rule.
+		NONE = -1,	///< Invalid step index.
+	};
+
+	/**
+	 * Create a trace recorder.
+	 *
+	 * @param capacity Maximum number of steps kept.
+	 * @param withEquations Whether equational steps are recorded.
+	 */
+	TraceRecorder(int capacity, bool withEquations = true);
+	~TraceRecorder();
+
+	/**
+	 * Start recording.
+	 */
+	void activate();
+
+	/**
+	 * Stop recording.
+	 */
+	void deactivate();
+
+	/**
+	 * Whether the recorder is active.
+	 */
+	bool isActive() const;
+
+	/**
+	 * Whether there is an active recorder.
+	 */
+	static bool isRecording();
+
+	/**
+	 * Get the number of steps kept in the buffer.
+	 */
+	int size() const;
+
+	/**
+	 * Get the number of steps recorded, including those dropped.
+	 */
+	long long getTotalSteps() const;
+
+	/**
+	 * Get the kind of a step.
+	 *
+	 * @param index Index of the step (from @c 0 for the oldest kept step).
+	 */
+	StepKind getKind(int index) const;
+
+	/**
+	 * Get the equation applied in a step (or null).
+	 */
+	Equation* getEquation(int index) const;
+
+	/**
+	 * Get the rule applied in a step (or null).
+	 */
+	Rule* getRule(int index) const;
+
+	/**
+	 * Get the redex of a step (or null if the index is not valid).
+	 */
+	EasyTerm* getRedex(int index) const;
+
+	/**
+	 * Get the result of a step (or null if it has not finished).
+	 */
+	EasyTerm* getResult(int index) const;
+
+	/**
+	 * Remove all steps from the buffer.
+	 */
+	void clear();
+
+private:
+	struct Step {
+		StepKind kind;
+		const PreEquation* statement;
+		DagNode* redex;
+		DagNode* result;
+	};
+
+	void markReachableNodes();
+
+	void record(StepKind kind, const PreEquation* statement, DagNode* redex);
+	void finish(DagNode* result);
+
+	const Step* at(int index) const;
+
+	std::vector<Step> steps;
+	size_t capacity;
+	size_t first = 0;
+	long long total = 0;
+	bool withEquations;
+	bool active = false;
+
+	// Recorder active when this one was activated
+	TraceRecorder* previous = nullptr;
+
+	static TraceRecorder* current;
+
+	friend class RecordingRewritingContext;
+};
+
+inline bool
+TraceRecorder::isActive() const {
+	return active;
+}
+
+inline bool
+TraceRecorder::isRecording() {
+	return current != nullptr;
+}
+
+inline int
+TraceRecorder::size() const {
+	return steps.size();
+}
+
+inline long long
+TraceRecorder::getTotalSteps() const {
+	return total;
+}
+
+#endif // TRACE_RECORDER_HH
@@ -0,0 +1,340 @@
+/**
+ * @file visited_set.cc
+ *
+ * Sets of visited states with full, compacted or disk storage.
+ */
+
+#include "macros.hh"
+#include "core.hh"
+#include "interface.hh"
+#include "mixfix.hh"
+
+#include "dagNode.hh"
+#include "dagArgumentIterator.hh"
+#include "visibleModule.hh"
+
+#include "visited_set.hh"
+#include "state_store.hh"
+#include "term_tables.hh"
+
+#include <cmath>
+#include <list>
+#include <unordered_map>
+
+using namespace std;
+
+/**
+ * Table of complete states.
+ */
+class StateTable : public TermTable {
+public:
+	StateTable(VisibleModule* vmod) : TermTable(vmod) {}
+
+	using TermTable::insert;
+};
+
+/**
+ * Table of complete states kept serialized in a file, with the most
+ * recently used ones cached in memory as DAGs.
+ *
+ * States are indexed by their fingerprints, and those with the same
+ * fingerprint are compared as DAGs to make the table exact.
+ */
+class DiskStateTable : private RootContainer {
+public:
+	DiskStateTable(VisibleModule* vmod, size_t cacheSize, const string &directory);
+	~DiskStateTable();
+
+	/**
+	 * Insert a reduced state.
+	 *
+	 * @return @c 1 if inserted, @c 0 if already present, and @c -1
+	 * if the state could not be stored.
+	 */
+	int insert(DagNode* dag, uint64_t fingerprint);
+
+	/**
+	 * Get the number of bytes of the stored states.
+	 */
+	size_t getByteSize() const;
+
+private:
+	typedef list<pair<size_t, DagNode*>> CacheList;
+
+	void markReachableNodes();
+	DagNode* fetch(size_t record);
+	void remember(size_t record, DagNode* dag);
+
+	VisibleModule* vmod;
+	StateStore store;
+	unordered_multimap<uint64_t, size_t> index;
+
+	size_t cacheSize;
+	CacheList cache;
+	unordered_map<size_t, CacheList::iterator> cacheIndex;
+};
+
+DiskStateTable::DiskStateTable(VisibleModule* vmod, size_t cacheSize, const string &directory)
+ : vmod(vmod),
+   store(true, directory),
+   cacheSize(max(cacheSize, size_t(1)))
+{
+	vmod->protect();
+	link();
+}
+
+DiskStateTable::~DiskStateTable() {
+	unlink();
+	(void) vmod->unprotect();
+}
+
+void
+DiskStateTable::markReachableNodes() {
+	for (auto &entry : cache)
+		entry.second->mark();
+}
+
+void
+DiskStateTable::remember(size_t record, DagNode* dag) {
+	cache.emplace_front(record, dag);
+	cacheIndex[record] = cache.begin();
+
+	if (cache.size() > cacheSize) {
+		cacheIndex.erase(cache.back().first);
+		cache.pop_back();
+	}
+}
+
+DagNode*
+DiskStateTable::fetch(size_t record) {
+	auto it = cacheIndex.find(record);
+
+	// Hits are moved to the front of the cache
+	if (it != cacheIndex.end()) {
+		cache.splice(cache.begin(), cache, it->second);
+		return it->second->second;
+	}
+
+	EasyTerm* term = EasyTerm::deserialize(vmod, store.get(record));
+
+	if (term == nullptr)
+		return nullptr;
+
+	DagNode* dag = term->getDag();
+	remember(record, dag);
+	delete term;
+
+	return dag;
+}
+
+int
+DiskStateTable::insert(DagNode* dag, uint64_t fingerprint) {
+	auto [begin, end] = index.equal_range(fingerprint);
+
+	for (auto it = begin; it != end; ++it) {
+		DagNode* stored = fetch(it->second);
+
+		if (stored != nullptr && stored->equal(dag))
+			return 0;
+	}
+
+	EasyTerm state(dag);
+	size_t record = store.append(state.serialize());
+
+	if (record == size_t(NONE))
+		return -1;
+
+	index.insert({fingerprint, record});
+	remember(record, dag);
+
+	return 1;
+}
+
+size_t
+DiskStateTable::getByteSize() const {
+	return store.getByteSize();
+}
+
+// Finalizer of MurmurHash3
+static inline uint64_t
+mix(uint64_t h) {
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+uint64_t
+fingerprint(DagNode* dag) {
+	unordered_map<DagNode*, uint64_t> known;
+
+	// Iterative postorder traversal of the DAG, where shared
+	// subterms are only visited once
+	vector<pair<DagNode*, bool>> pending = {{dag, false}};
+
+	while (!pending.empty()) {
+		auto [node, expanded] = pending.back();
+
+		if (known.find(node) != known.end()) {
+			pending.pop_back();
+			continue;
+		}
+
+		if (!expanded) {
+			pending.back().second = true;
+
+			for (DagArgumentIterator it(node); it.valid(); it.next())
+				pending.push_back({it.argument(), false});
+			continue;
+		}
+
+		pending.pop_back();
+
+		// The hash value of the node covers the data of built-in
+		// constants, which are not reached by the argument iterator
+		uint64_t value = mix((uint64_t(node->symbol()->getIndexWithinModule()) << 32)
+			^ node->getHashValue());
+
+		for (DagArgumentIterator it(node); it.valid(); it.next())
+			value = mix(value ^ (known[it.argument()] + 0x9e3779b97f4a7c15ULL
+				+ (value << 6) + (value >> 2)));
+
+		known[node] = value;
+	}
+
+	return known[dag];
+}
+
+VisitedSet::VisitedSet(VisibleModule* vmod, StateStorage storage, int log2Size,
+                       const string &directory)
+ : storage(storage)
+{
+	switch (storage) {
+		case FULL_STATES:
+			table = make_unique<StateTable>(vmod);
+			break;
+
+		case HASH_COMPACTION:
+			fingerprints.resize(INITIAL_FINGERPRINTS, EMPTY_FINGERPRINT);
+			break;
+
+		case BITSTATE_HASHING:
+			// Arrays range from 64 bits to 128 GiB
+			log2Size = log2Size < 0 ? DEFAULT_LOG2_BITS : min(max(log2Size, 6), 40);
+			bits.resize(size_t(1) << (log2Size - 6));
+			bitMask = (uint64_t(1) << log2Size) - 1;
+			break;
+
+		case DISK_STATES:
+			log2Size = log2Size < 0 ? DEFAULT_LOG2_CACHE : min(log2Size, 40);
+			diskTable = make_unique<DiskStateTable>(vmod, size_t(1) << log2Size, directory);
+			break;
+	}
+}
+
+VisitedSet::~VisitedSet() = default;
+
+bool
+VisitedSet::insert(DagNode* dag) {
+	// Probability that a new state is wrongly taken as visited
+	double collision = 0.0;
+	bool isNew = false;
+
+	switch (storage) {
+		case FULL_STATES:
+			isNew = table->insert(dag).second;
+			break;
+
+		case HASH_COMPACTION:
+			collision = ldexp(double(nrStates), -64);
+			isNew = insertFingerprint(fingerprint(dag));
+			break;
+
+		case BITSTATE_HASHING: {
+			uint64_t h1 = fingerprint(dag), h2 = mix(h1) | 1;
+			collision = pow(double(nrBitsSet) / (bitMask + 1.0), NR_BIT_HASHES);
+
+			// Double hashing to obtain the bit positions
+			for (int i = 0; i < NR_BIT_HASHES; i++) {
+				uint64_t position = (h1 + i * h2) & bitMask;
+				uint64_t &word = bits[position >> 6];
+				uint64_t bit = uint64_t(1) << (position & 63);
+
+				if ((word & bit) == 0) {
+					word |= bit;
+					nrBitsSet++;
+					isNew = true;
+				}
+			}
+			break;
+		}
+
+		case DISK_STATES: {
+			int result = diskTable->insert(dag, fingerprint(dag));
+			failed = failed || result < 0;
+			isNew = result > 0;
+			break;
+		}
+	}
+
+	if (isNew) {
+		nrStates++;
+		logNoOmission += log1p(-collision);
+	}
+
+	return isNew;
+}
+
+bool
+VisitedSet::insertFingerprint(uint64_t value) {
+	// The reserved value is merged with another fingerprint, which
+	// only adds a negligible chance of collision
+	if (value == EMPTY_FINGERPRINT)
+		value = ~EMPTY_FINGERPRINT;
+
+	// The table is doubled before it becomes half full
+	if (2 * (nrStates + 1) > (long long) fingerprints.size()) {
+		vector<uint64_t> old(fingerprints.size() * 2, EMPTY_FINGERPRINT);
+		old.swap(fingerprints);
+		size_t mask = fingerprints.size() - 1;
+
+		for (uint64_t stored : old)
+			if (stored != EMPTY_FINGERPRINT) {
+				size_t slot = mix(stored) & mask;
+
+				while (fingerprints[slot] != EMPTY_FINGERPRINT)
+					slot = (slot + 1) & mask;
+
+				fingerprints[slot] = stored;
+			}
+	}
+
+	size_t mask = fingerprints.size() - 1;
+	size_t slot = mix(value) & mask;
+
+	while (fingerprints[slot] != EMPTY_FINGERPRINT) {
+		if (fingerprints[slot] == value)
+			return false;
+
+		slot = (slot + 1) & mask;
+	}
+
+	fingerprints[slot] = value;
+	return true;
+}
+
+long long
+VisitedSet::getByteSize() const {
+	switch (storage) {
+		case HASH_COMPACTION:
+			return fingerprints.capacity() * sizeof(uint64_t);
+		case BITSTATE_HASHING:
+			return bits.size() * sizeof(uint64_t);
+		case DISK_STATES:
+			return diskTable->getByteSize();
+		default:
+			return 0;
+	}
+}
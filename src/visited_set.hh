@@ -0,0 +1,147 @@
+/**
+ * @file visited_set.hh
+ *
+ * Sets of visited states with full, compacted or disk storage.
+ */
+
+#ifndef VISITED_SET_HH
+#define VISITED_SET_HH
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class DagNode;
+class VisibleModule;
+class StateTable;
+class DiskStateTable;
+
+/**
+ * Storage of the visited states of a search.
+ */
+enum StateStorage {
+	FULL_STATES,		///< Complete states (exact)
+	HASH_COMPACTION,	///< 64-bit fingerprints of the states
+	BITSTATE_HASHING,	///< Bits of a fixed-size array set by the states
+	DISK_STATES,		///< Complete states in a file with a cache in memory (exact)
+};
+
+/**
+ * Compute a 64-bit fingerprint of a DAG from its structure.
+ *
+ * Fingerprints are canonical for reduced DAGs, whose arguments under
+ * equational axioms are kept in a normal order.
+ */
+uint64_t fingerprint(DagNode* dag);
+
+/**
+ * Set of visited states.
+ *
+ * With compacted storage, a new state may be wrongly considered
+ * visited when its fingerprint or bits coincide with those of other
+ * states, so the search may omit part of the state space. The
+ * probability of these omissions is estimated as states are inserted.
+ */
+class VisitedSet {
+public:
+	/**
+	 * Create a visited set.
+	 *
+	 * @param vmod Module of the states.
+	 * @param storage Storage mode.
+	 * @param log2Size Base-2 logarithm of the number of bits of the
+	 * array for @c BITSTATE_HASHING, or of the number of states cached
+	 * in memory for @c DISK_STATES (negative for the default of each mode).
+	 * @param directory Directory of the state file for @c DISK_STATES.
+	 */
+	VisitedSet(VisibleModule* vmod, StateStorage storage = FULL_STATES, int log2Size = -1,
+	           const std::string &directory = "");
+	~VisitedSet();
+
+	/**
+	 * Insert a reduced state.
+	 *
+	 * @return Whether the state was not considered visited.
+	 */
+	bool insert(DagNode* dag);
+
+	/**
+	 * Whether a state could not be stored (because the disk is full).
+	 */
+	bool hasFailed() const;
+
+	/**
+	 * Get the number of states inserted.
+	 */
+	long long size() const;
+
+	/**
+	 * Get the number of bytes of the compacted or disk storage (the
+	 * complete states are kept in the Maude heap and are not counted).
+	 */
+	long long getByteSize() const;
+
+	/**
+	 * Get the natural logarithm of the estimated probability that
+	 * no state has been omitted.
+	 */
+	double getLogNoOmission() const;
+
+	/**
+	 * Get the storage mode.
+	 */
+	StateStorage getStorage() const;
+
+private:
+	// Number of bits set per state in bitstate hashing
+	static constexpr int NR_BIT_HASHES = 3;
+	// Default base-2 logarithms of the size of the bit array and of
+	// the cache of disk states (which should not hold all states)
+	static constexpr int DEFAULT_LOG2_BITS = 27;
+	static constexpr int DEFAULT_LOG2_CACHE = 16;
+	// Reserved value of the empty slots of the fingerprint table
+	static constexpr uint64_t EMPTY_FINGERPRINT = 0;
+	// Initial number of slots of the fingerprint table
+	static constexpr size_t INITIAL_FINGERPRINTS = 1024;
+
+	/**
+	 * Insert a fingerprint in the open-addressing table.
+	 *
+	 * @return Whether the fingerprint was not in the table.
+	 */
+	bool insertFingerprint(uint64_t value);
+
+	StateStorage storage;
+	std::unique_ptr<StateTable> table;
+	std::unique_ptr<DiskStateTable> diskTable;
+	std::vector<uint64_t> fingerprints;	// Linear probing with a load factor up to 1/2
+	std::vector<uint64_t> bits;
+	uint64_t bitMask = 0;
+	long long nrBitsSet = 0;
+	long long nrStates = 0;
+	double logNoOmission = 0.0;
+	bool failed = false;
+};
+
+inline bool
+VisitedSet::hasFailed() const {
+	return failed;
+}
+
+inline long long
+VisitedSet::size() const {
+	return nrStates;
+}
+
+inline double
+VisitedSet::getLogNoOmission() const {
+	return logNoOmission;
+}
+
+inline StateStorage
+VisitedSet::getStorage() const {
+	return storage;
+}
+
+#endif // VISITED_SET_HH
@@ -0,0 +1,56 @@
+//
+//	Interface to the cancellation of Maude operations
+//
+
+/**
+ * Token to cancel the Maude operations executed while it is active,
+ * either explicitly or when a timeout expires.
+ *
+ * Operations are stopped at rewrite granularity, as with Ctrl+C, so
+ * reductions and rewrites leave their terms partially evaluated and
+ * searches and model checking end prematurely. Whether this has
+ * happened can be checked with isCancelled and hasExpired.
+ */
+class CancellationToken {
+public:
+	/**
+	 * Create a cancellation token.
+	 *
+	 * @param timeout Maximum time in seconds since the activation of
+	 * the token (negative for no timeout).
+	 */
+	CancellationToken(double timeout = -1);
+	~CancellationToken();
+
+	/**
+	 * Cancel the operations executed while the token is active.
+	 * It can be called from other threads.
+	 */
+	void cancel();
+
+	/**
+	 * Start a time-bounded region (operations are cancelled when
+	 * the token is cancelled or the timeout expires).
+	 */
+	void activate();
+
+	/**
+	 * End the time-bounded region.
+	 */
+	void deactivate();
+
+	/**
+	 * Whether the token is active.
+	 */
+	bool isActive() const;
+
+	/**
+	 * Whether the token has been cancelled or its timeout has expired.
+	 */
+	bool isCancelled() const;
+
+	/**
+	 * Whether the timeout has expired during the last activation.
+	 */
+	bool hasExpired() const;
+};
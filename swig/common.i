@@ -190,11 +190,12 @@
 //
 
 // Destructor for SearchState that removes the protection
-// added to the module before the search
+// added to the module before the search (and its progress monitor)
 %define %unprotectDestructor(name)
 	%extend {
 		~name() {
 			dynamic_cast<ImportModule*>($self->getContext()->root()->symbol()->getModule())->unprotect();
+			forgetMonitor($self);
 			delete $self;
 		}
 	}
@@ -25,6 +25,10 @@
 #include "maude_wrappers.hh"
 #include "easyTerm.hh"
 #include "narrowing.hh"
+#include "cancellation.hh"
+#include "profiling.hh"
+#include "search_path.hh"
+#include "best_first_search.hh"
 
 #include "equation.hh"
 #include "rule.hh"
@@ -43,6 +47,8 @@ namespace std {
 	%template (ModuleHeaderVector) vector<ModuleHeader>;
 	%template (TermVector) vector<EasyTerm*>;
 	%template (StringVector) vector<std::string>;
+	%template (IntVector) vector<int>;
+	%template (LongVector) vector<long long>;
 	%template (TermPair) pair<EasyTerm*, EasyTerm*>;
 	%template (TermPairVector) vector<pair<EasyTerm*, EasyTerm*>>;
 
@@ -50,10 +56,14 @@ namespace std {
 	// In Python, avoid generating the full implementation of vectors
 	// when they are only used as return values in functions
 	%template (ViewVector) vector<View*>;
-	%template (IntVector) vector<int>;
+	%template (DoubleVector) vector<double>;
 	%template (TermIntPair) pair<EasyTerm*, int>;
 	%template (TermSubstitutionPair) pair<EasyTerm*, EasySubstitution*>;
 	%template (StringVectorVector) vector<vector<std::string>>;
+	%template (TermIntPairVector) vector<pair<EasyTerm*, int>>;
+	%template (TermVectorVector) vector<vector<EasyTerm*>>;
+	%template (SearchSolutionVector) vector<SearchSolution>;
+	%template (PathStepVector) vector<PathStep>;
 #endif
 }
 
@@ -229,12 +239,51 @@ void setRandomSeed(int randomSeed);
  */
 bool setAssocUnifDepth(float m);
 
+/**
+ * Enable or disable the profiler, whose data can be obtained
+ * with the getProfile method of modules.
+ *
+ * @param flag Whether profiling is enabled.
+ * @param clearEachCall Whether the profile of a module is cleared
+ * at the beginning of each operation on it.
+ */
+void setProfiling(bool flag, bool clearEachCall = true);
+
+%immutable GcStats;
+
+/**
+ * Statistics of the garbage collector.
+ */
+struct GcStats {
+	long long collections;	///< Number of collections since initialization.
+	long long nodesInUse;	///< Number of live nodes after the last collection.
+	long long arenas;	///< Number of node arenas allocated.
+	double forcedTime;	///< Time in seconds spent in forced collections.
+	long long roots;	///< Number of terms and substitutions held by the bindings.
+};
+
+/**
+ * Get the statistics of the garbage collector.
+ */
+GcStats getGcStats();
+
+/**
+ * Run the garbage collector now (for example, after releasing many
+ * terms or between batches of work, to avoid a latency spike later).
+ */
+void collectGarbage();
+
 // Global constants
 %constant int UNBOUNDED = INT_MAX;
 %constant const char* MAUDE_VERSION = PACKAGE_VERSION;
 
+%include monitor.i
 %include misc.i
 %include term.i
 %include module.i
 %include view.i
 %include hook.i
+%include pool.i
+%include tables.i
+%include cancellation.i
+%include recorder.i
@@ -16,6 +16,7 @@
 #include "strategyTransitionGraph.hh"
 #include "userLevelRewritingContext.hh"
 #include "importTranslation.hh"
+#include "trace_recorder.hh"
 
 #include "helper_funcs.hh"
 %}
@@ -739,7 +740,7 @@ public:
 		 * @param term Initial state term (it will be reduced).
 		 */
 		StateTransitionGraph(EasyTerm* term) {
-			RewritingContext* context = new UserLevelRewritingContext(term->getDag());
+			RewritingContext* context = new RecordingRewritingContext(term->getDag());
 			context->reduce();
 			return new StateTransitionGraph(context);
 		}
@@ -753,6 +754,29 @@ public:
 			return new EasyTerm($self->getStateDag(stateNr));
 		}
 
+		/**
+		 * Get a path from the initial state to the given one
+		 * (following the parents of the states).
+		 *
+		 * @param stateNr A state number.
+		 *
+		 * @return The states of the path with the rules leading to them
+		 * (empty if the state is not valid).
+		 */
+		std::vector<PathStep> getPath(int stateNr) {
+			return getPath(*$self, stateNr);
+		}
+
+		/**
+		 * Get the state numbers of a path from the initial state
+		 * to the given one.
+		 *
+		 * @param stateNr A state number.
+		 */
+		std::vector<int> getPathStates(int stateNr) {
+			return getPathStates(*$self, stateNr);
+		}
+
 		/**
 		 * Get a rule that connects two states.
 		 *
@@ -776,6 +800,13 @@ public:
 			return $self->getContext()->getTotalCount();
 		}
 
+		/**
+		 * Get the rewrite counts used to generate this graph.
+		 */
+		RewriteStats getStats() {
+			return StatsRecorder::fromContext($self->getContext());
+		}
+
 		/**
 		 * Model check a given LTL formula.
 		 *
@@ -784,23 +815,56 @@ public:
 		 * @return The result of model checking.
 		 */
 		ModelCheckResult* modelCheck(EasyTerm* formula) {
+			SearchMonitor::Scope scope(findMonitor($self));
 			return modelCheck(*$self, formula->getDag());
 		}
+
+		/**
+		 * List the successors of a state in the graph.
+		 *
+		 * @param stateNr A state number.
+		 * @param index A child index (from zero).
+		 *
+		 * @return The state number of a successor or -1.
+		 */
+		int getNextState(int stateNr, int index) {
+			SearchMonitor::Scope scope(findMonitor($self));
+			return $self->getNextState(stateNr, index);
+		}
+
+		/**
+		 * Get the current progress of the exploration of the graph.
+		 */
+		SearchProgress getProgress() {
+			return getMonitor($self)->getProgress();
+		}
+
+		/**
+		 * Set a callback for the progress of the exploration of the
+		 * graph, which is checked at every rule rewrite.
+		 *
+		 * @param callback Callback object (that must outlive the graph)
+		 * or null to remove the current one.
+		 * @param everyStates Number of new states between calls
+		 * (non-positive to disable this criterion).
+		 * @param everyMillis Milliseconds between calls (non-positive
+		 * to disable this criterion).
+		 */
+		void setProgressCallback(ProgressCallback* callback, long long everyStates = 0,
+		                         double everyMillis = 1000) {
+			getMonitor($self)->setCallback(callback, everyStates, everyMillis);
+		}
+
+		~StateTransitionGraph() {
+			forgetMonitor($self);
+			delete $self;
+		}
 	}
 
 	/**
 	 * Get the number of states in the graph.
 	 */
 	int getNrStates() const;
-	/**
-	 * List the successors of a state in the graph.
-	 *
-	 * @param stateNr A state number.
-	 * @param index A child index (from zero).
-	 *
-	 * @return The state number of a successor or -1.
-	 */
-	int getNextState(int stateNr, int index);
 	/**
 	 * Get the (one) parent of a given state.
 	 *
@@ -887,7 +951,7 @@ public:
 		 */
 		StrategyTransitionGraph(EasyTerm* initial, StrategyExpression* strat,
 					const std::vector<std::string> &opaques = {}, bool biased=false) {
-			RewritingContext* context = new UserLevelRewritingContext(initial->getDag());
+			RewritingContext* context = new RecordingRewritingContext(initial->getDag());
 			context->reduce();
 			set<int> opaqueIds;
 			for (auto &name : opaques)
@@ -911,6 +975,29 @@ public:
 			return new EasyTerm($self->getStateDag(stateNr));
 		}
 
+		/**
+		 * Get a path from the initial state to the given one
+		 * (a shortest one in the explored part of the graph).
+		 *
+		 * @param stateNr A state number.
+		 *
+		 * @return The states of the path with the transitions leading to them
+		 * (empty if the state is not valid).
+		 */
+		std::vector<PathStep> getPath(int stateNr) {
+			return getPath(*$self, stateNr);
+		}
+
+		/**
+		 * Get the state numbers of a path from the initial state
+		 * to the given one.
+		 *
+		 * @param stateNr A state number.
+		 */
+		std::vector<int> getPathStates(int stateNr) {
+			return getPathStates(*$self, stateNr);
+		}
+
 		/**
 		 * Get the strategy that will be executed next
 		 * from the given state.
@@ -947,6 +1034,13 @@ public:
 			return $self->getContext()->getTotalCount();
 		}
 
+		/**
+		 * Get the rewrite counts used to generate this graph.
+		 */
+		RewriteStats getStats() {
+			return StatsRecorder::fromContext($self->getContext());
+		}
+
 		/**
 		 * Model check a given LTL formula.
 		 *
@@ -955,8 +1049,50 @@ public:
 		 * @return The result of model checking.
 		 */
 		ModelCheckResult* modelCheck(EasyTerm* formula) {
+			SearchMonitor::Scope scope(findMonitor($self));
 			return modelCheck(*$self, formula->getDag());
 		}
+
+		/**
+		 * List the successors of a state in the graph.
+		 *
+		 * @param stateNr A state number.
+		 * @param index A child index (from zero).
+		 *
+		 * @return The state number of a successor or -1.
+		 */
+		int getNextState(int stateNr, int index) {
+			SearchMonitor::Scope scope(findMonitor($self));
+			return $self->getNextState(stateNr, index);
+		}
+
+		/**
+		 * Get the current progress of the exploration of the graph.
+		 */
+		SearchProgress getProgress() {
+			return getMonitor($self)->getProgress();
+		}
+
+		/**
+		 * Set a callback for the progress of the exploration of the
+		 * graph, which is checked at every rule rewrite.
+		 *
+		 * @param callback Callback object (that must outlive the graph)
+		 * or null to remove the current one.
+		 * @param everyStates Number of new states between calls
+		 * (non-positive to disable this criterion).
+		 * @param everyMillis Milliseconds between calls (non-positive
+		 * to disable this criterion).
+		 */
+		void setProgressCallback(ProgressCallback* callback, long long everyStates = 0,
+		                         double everyMillis = 1000) {
+			getMonitor($self)->setCallback(callback, everyStates, everyMillis);
+		}
+
+		~StrategyTransitionGraph() {
+			forgetMonitor($self);
+			delete $self;
+		}
 	}
 
 	/**
@@ -967,15 +1103,6 @@ public:
 	 * Get the number of real (not merged) states in the graph (in linear time).
 	 */
 	int getNrRealStates() const;
-	/**
-	 * List the successors of a state in the graph.
-	 *
-	 * @param stateNr A state number.
-	 * @param index A child index (from zero).
-	 *
-	 * @return The state number of a successor or -1.
-	 */
-	int getNextState(int stateNr, int index);
 	/**
 	 * Whether the state is a solution for the strategy.
 	 *
@@ -983,3 +1110,15 @@ public:
 	 */
 	bool isSolutionState(int stateNr) const;
 };
+
+%immutable PathStep;
+
+/**
+ * Step of a path in a search or rewrite graph.
+ */
+struct PathStep {
+	int stateNr;		///< State number.
+	EasyTerm* term;		///< State term.
+	Rule* rule;		///< Rule leading to the state (null for the first one or non-rule transitions).
+	const StrategyTransitionGraph::Transition* transition;	///< Transition leading to the state (in strategy-controlled graphs).
+};
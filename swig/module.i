@@ -10,8 +10,38 @@
 #include "filteredVariantUnifierSearch.hh"
 #include "irredundantUnificationProblem.hh"
 #include "pointerMap.hh"
+#include "module_cache.hh"
 %}
 
+%immutable CacheStats;
+
+/**
+ * Statistics of a cache.
+ */
+struct CacheStats {
+	long long hits;		///< Number of successful lookups.
+	long long misses;	///< Number of failed lookups.
+	long long evictions;	///< Number of entries removed to make room for others.
+	long long size;		///< Current number of entries.
+	long long capacity;	///< Maximum number of entries.
+};
+
+%immutable StatementStats;
+
+/**
+ * Profile of a statement (equation, rule, membership axiom or
+ * strategy definition).
+ *
+ * Condition starts are only counted for conditional statements.
+ * The evaluation of a condition fails when one of its fragments fails.
+ */
+struct StatementStats {
+	long long rewrites;			///< Number of times the statement has been applied.
+	long long conditionStarts;		///< Number of matches that started the evaluation of the condition.
+	std::vector<long long> fragmentSuccesses;	///< Number of successes of each condition fragment.
+	std::vector<long long> fragmentFailures;	///< Number of failures of each condition fragment.
+};
+
 %rename (Module) VisibleModule;
 
 /**
@@ -218,30 +248,43 @@ public:
 		 * annotation in the strategy.
 		 */
 		EasyTerm* parseTerm(const char* term_str, ConnectedComponent* kind = nullptr, const std::vector<EasyTerm*> &vars = {}) {
-			Vector<Token> tokens;
-			tokenize(term_str, tokens);
-
 			MixfixModule::AliasMap aliasMap;
 			MixfixParser* parser = nullptr;
 
-			if (!vars.empty()) {
-				for (EasyTerm* term : vars) {
-					if (VariableDagNode* var = dynamic_cast<VariableDagNode*>(term->getDag()))
-						aliasMap.insert({var->id(), var->symbol()->getRangeSort()});
-					else {
-						IssueWarning("the given list of variables contains terms that are not variables.");
-						return nullptr;
-					}
+			for (EasyTerm* term : vars) {
+				if (VariableDagNode* var = dynamic_cast<VariableDagNode*>(term->getDag()))
+					aliasMap.insert({var->id(), var->symbol()->getRangeSort()});
+				else {
+					IssueWarning("the given list of variables contains terms that are not variables.");
+					return nullptr;
 				}
-				$self->swapVariableAliasMap(aliasMap, parser);
 			}
 
+			// Look for the term in the parse cache (if enabled)
+			ParseCache* cache = ParseCache::find($self);
+
+			if (cache != nullptr)
+				if (Term* term = cache->getTerm(term_str, kind, aliasMap))
+					return new EasyTerm(term);
+
+			Vector<Token> tokens;
+			tokenize(term_str, tokens);
+
+			if (!vars.empty())
+				$self->swapVariableAliasMap(aliasMap, parser);
+
 			Term* term = $self->parseTerm(tokens, kind);
 
 			if (!vars.empty())
 				$self->swapVariableAliasMap(aliasMap, parser);
 
-			return term != nullptr ? new EasyTerm(term) : nullptr;
+			if (term == nullptr)
+				return nullptr;
+
+			if (cache != nullptr)
+				cache->putTerm(term_str, kind, aliasMap, term);
+
+			return new EasyTerm(term);
 		}
 
 		/**
@@ -252,32 +295,146 @@ public:
 		 * annotation in the strategy.
 		 */
 		StrategyExpression* parseStrategy(const char* strat_str, const std::vector<EasyTerm*> &vars = {}) {
-			Vector<Token> tokens;
-			tokenize(strat_str, tokens);
-
 			MixfixModule::AliasMap aliasMap;
 			MixfixParser* parser = nullptr;
 
-			if (!vars.empty()) {
-				for (EasyTerm* term : vars) {
-					if (VariableDagNode* var = dynamic_cast<VariableDagNode*>(term->getDag()))
-						aliasMap.insert({var->id(), var->symbol()->getRangeSort()});
-					else {
-						IssueWarning("the given list of variables contains terms that are not variables.");
-						return nullptr;
-					}
+			for (EasyTerm* term : vars) {
+				if (VariableDagNode* var = dynamic_cast<VariableDagNode*>(term->getDag()))
+					aliasMap.insert({var->id(), var->symbol()->getRangeSort()});
+				else {
+					IssueWarning("the given list of variables contains terms that are not variables.");
+					return nullptr;
 				}
-				$self->swapVariableAliasMap(aliasMap, parser);
 			}
 
+			// Look for the strategy in the parse cache (if enabled)
+			ParseCache* cache = ParseCache::find($self);
+
+			if (cache != nullptr)
+				if (StrategyExpression* expr = cache->getStrategy(strat_str, aliasMap))
+					return expr;
+
+			Vector<Token> tokens;
+			tokenize(strat_str, tokens);
+
+			if (!vars.empty())
+				$self->swapVariableAliasMap(aliasMap, parser);
+
 			StrategyExpression* expr = $self->parseStrategyExpr(tokens);
 
 			if (!vars.empty())
 				$self->swapVariableAliasMap(aliasMap, parser);
 
+			if (expr != nullptr && cache != nullptr)
+				cache->putStrategy(strat_str, aliasMap, expr);
+
 			return expr;
 		}
 
+		/**
+		 * Set the maximum number of entries of the parse cache of
+		 * this module, which stores the terms and strategies parsed
+		 * from strings with parseTerm and parseStrategy.
+		 *
+		 * @param size Maximum number of entries (@c 0 disables the cache,
+		 * which is the default).
+		 */
+		void setParseCacheSize(int size) {
+			ParseCache::setCapacity($self, size > 0 ? size : 0);
+		}
+
+		/**
+		 * Get the statistics of the parse cache of this module.
+		 */
+		CacheStats getParseCacheStats() {
+			return ParseCache::getStats($self);
+		}
+
+		/**
+		 * Remove all the entries of the parse cache of this module.
+		 */
+		void clearParseCache() {
+			if (ParseCache* cache = ParseCache::find($self))
+				cache->clear();
+		}
+
+		/**
+		 * Set the maximum number of entries of the normal form cache
+		 * of this module, which stores the results of reducing ground
+		 * terms with reduce and reduceMany.
+		 *
+		 * The cache should only be enabled when reduction is
+		 * deterministic, i.e. when the module does not use random
+		 * numbers, counters, or external objects.
+		 *
+		 * @param size Maximum number of entries (@c 0 disables the cache,
+		 * which is the default).
+		 */
+		void setNormalFormCacheSize(int size) {
+			NormalFormCache::setMaxEntries($self, size > 0 ? size : 0);
+		}
+
+		/**
+		 * Get the statistics of the normal form cache of this module.
+		 */
+		CacheStats getNormalFormCacheStats() {
+			return NormalFormCache::getStats($self);
+		}
+
+		/**
+		 * Remove all the entries of the normal form cache of this module.
+		 */
+		void clearNormalFormCache() {
+			if (NormalFormCache* cache = NormalFormCache::find($self))
+				cache->clear();
+		}
+
+		/**
+		 * Get the profile of an equation of this module (profiling
+		 * should have been enabled with setProfiling).
+		 */
+		StatementStats getProfile(Equation* eq) {
+			return getStatementStats($self, eq);
+		}
+
+		/**
+		 * Get the profile of a rule of this module.
+		 */
+		StatementStats getProfile(Rule* rl) {
+			return getStatementStats($self, rl);
+		}
+
+		/**
+		 * Get the profile of a membership axiom of this module.
+		 */
+		StatementStats getProfile(SortConstraint* mb) {
+			return getStatementStats($self, mb);
+		}
+
+		/**
+		 * Get the profile of a strategy definition of this module.
+		 */
+		StatementStats getProfile(StrategyDefinition* sdef) {
+			return getStatementStats($self, sdef);
+		}
+
+		/**
+		 * Print the profile of this module as the @c show @c profile
+		 * command does.
+		 */
+		std::string showProfile() {
+			std::ostringstream stream;
+			$self->showProfile(stream);
+			return stream.str();
+		}
+
+		/**
+		 * Clear the profile of this module.
+		 */
+		void clearProfile() {
+			$self->clearProfile();
+		}
+
 		/**
 		 * Get a term in this module from its metarepresentation
 		 * in (possibly) another module.
@@ -559,6 +716,30 @@ public:
 
 			return EasyTerm::vu_narrow(subject, type, target, depth, flags);
 		}
+
+		/**
+		 * Reduce many terms of this module at once (in place).
+		 *
+		 * @param terms The terms to be reduced.
+		 *
+		 * @return The total number of rewrites for each term.
+		 */
+		std::vector<int> reduceMany(const std::vector<EasyTerm*> &terms) {
+			return EasyTerm::reduceMany(terms);
+		}
+
+		/**
+		 * Rewrite many terms of this module at once (in place)
+		 * following the semantics of the @c rewrite command.
+		 *
+		 * @param terms The terms to be rewritten.
+		 * @param bound An upper bound on the number of rule rewrites per term.
+		 *
+		 * @return The total number of rewrites for each term.
+		 */
+		std::vector<int> rewriteMany(const std::vector<EasyTerm*> &terms, int bound = -1) {
+			return EasyTerm::rewriteMany(terms, bound);
+		}
 	}
 
 	%extend {
@@ -599,6 +780,24 @@ public:
 					 : nullptr;
 		}
 
+		/**
+		 * Get the next unifiers.
+		 *
+		 * @param n Maximum number of unifiers.
+		 *
+		 * @return Up to @c n unifiers (fewer if the end has been reached).
+		 */
+		std::vector<SearchSolution> next(int n) {
+			std::vector<SearchSolution> solutions;
+
+			for (int i = 0; i < n && $self->findNextUnifier(); i++)
+				solutions.push_back({nullptr, new EasySubstitution(&$self->getSolution(),
+				                                                   &$self->getVariableInfo()),
+				                     nullptr, -1, -1});
+
+			return solutions;
+		}
+
 		~UnificationProblem() {
 			getModule($self)->unprotect();
 		}
@@ -631,5 +830,29 @@ public:
 	 */
 	EasySubstitution* __next();
 
+	%extend {
+		/**
+		 * Get the next unifiers.
+		 *
+		 * @param n Maximum number of unifiers.
+		 *
+		 * @return Up to @c n unifiers (fewer if the end has been reached).
+		 */
+		std::vector<SearchSolution> next(int n) {
+			std::vector<SearchSolution> solutions;
+
+			for (int i = 0; i < n; i++) {
+				EasySubstitution* unifier = $self->__next();
+
+				if (unifier == nullptr)
+					break;
+
+				solutions.push_back({nullptr, unifier, nullptr, -1, -1});
+			}
+
+			return solutions;
+		}
+	}
+
 	%unprotectDestructor(VariantUnifierSearch);
 };
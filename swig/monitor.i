@@ -0,0 +1,49 @@
+//
+//	Interface to the progress of searches
+//
+
+%{
+#include "search_monitor.hh"
+%}
+
+%immutable SearchProgress;
+
+/**
+ * Snapshot of the progress of a search.
+ *
+ * Counters that are not available for a kind of search are @c -1. In
+ * the sequential searches, the number of duplicates is estimated from
+ * the rule rewrites and the size of the frontier is only available for
+ * the breadth-first search without strategy. The time of the sequential
+ * searches is measured since their progress is first requested or a
+ * callback is set.
+ */
+struct SearchProgress {
+	long long nrStates;		///< Number of distinct states generated.
+	long long nrDuplicates;		///< Number of successors that had already been visited.
+	long long frontierSize;		///< Number of states pending exploration.
+	int depth;			///< Depth of the deepest state generated.
+	long long rewrites;		///< Number of rewrites.
+	long long storageBytes;		///< Bytes used to store states outside the Maude heap.
+	double elapsed;			///< Seconds spent in the search.
+	double statesPerSecond;		///< Average number of states generated per second.
+};
+
+%feature("director") ProgressCallback;
+
+/**
+ * Callback for the progress of a search.
+ */
+struct ProgressCallback {
+	/**
+	 * Method called periodically during the search.
+	 *
+	 * The search can be stopped from here by cancelling an active
+	 * cancellation token. Maude operations should not be executed
+	 * in the callback.
+	 *
+	 * @param progress Current progress of the search.
+	 */
+	virtual void report(const SearchProgress &progress) = 0;
+	virtual ~ProgressCallback() {};
+};
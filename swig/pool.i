@@ -0,0 +1,448 @@
+//
+//	Interface to the pool of worker processes
+//
+
+%{
+#include "engine_pool.hh"
+#include "parallel_search.hh"
+#include "simulation.hh"
+#include "statistical_checking.hh"
+%}
+
+/**
+ * Pool of worker processes forked from the current one to distribute
+ * reductions, rewrites and searches among the available cores.
+ *
+ * Workers share the modules loaded before the creation of the pool,
+ * which are looked up by name, so modules loaded or replaced afterwards
+ * are not visible to them. Terms are transferred between processes and
+ * returned as new terms of the original modules.
+ */
+class EnginePool {
+public:
+	/**
+	 * Create a pool of workers.
+	 *
+	 * @param nrWorkers Number of worker processes (@c -1 for as many as
+	 * available cores, @c 0 to execute the jobs in the current process).
+	 */
+	EnginePool(int nrWorkers = -1);
+	~EnginePool();
+
+	/**
+	 * Get the number of alive workers.
+	 */
+	int getNrWorkers() const;
+
+	/**
+	 * Reduce the given terms in parallel.
+	 *
+	 * @param terms Terms to be reduced (they are not modified).
+	 *
+	 * @return The reduced terms (null if the job failed) with their
+	 * total number of rewrites.
+	 */
+	std::vector<std::pair<EasyTerm*, int>> reduce(const std::vector<EasyTerm*> &terms);
+
+	/**
+	 * Rewrite the given terms in parallel following the semantics
+	 * of the @c rewrite command.
+	 *
+	 * @param terms Terms to be rewritten (they are not modified).
+	 * @param bound An upper bound on the number of rule rewrites per term.
+	 *
+	 * @return The rewritten terms (null if the job failed) with their
+	 * total number of rewrites.
+	 */
+	std::vector<std::pair<EasyTerm*, int>> rewrite(const std::vector<EasyTerm*> &terms, int bound = -1);
+
+	/**
+	 * Rewrite the given terms in parallel following the semantics
+	 * of the @c frewrite command.
+	 *
+	 * @param terms Terms to be rewritten (they are not modified).
+	 * @param bound An upper bound on the number of rule rewrites per term.
+	 * @param gas An upper bound on the number of rule rewrites per position.
+	 *
+	 * @return The rewritten terms (null if the job failed) with their
+	 * total number of rewrites.
+	 */
+	std::vector<std::pair<EasyTerm*, int>> frewrite(const std::vector<EasyTerm*> &terms,
+	                                                int bound = -1, int gas = -1);
+
+	/**
+	 * Search from each of the given terms in parallel.
+	 *
+	 * @param terms Initial terms of the searches.
+	 * @param type Type of search (number of steps).
+	 * @param target Pattern term.
+	 * @param depth Depth bound.
+	 * @param maxSolutions Maximum number of solutions per search (@c -1 for all).
+	 *
+	 * @return The solutions for each initial term.
+	 */
+	std::vector<std::vector<EasyTerm*>> search(const std::vector<EasyTerm*> &terms,
+	                                           SearchType type, EasyTerm* target,
+	                                           int depth = -1, int maxSolutions = -1);
+
+	/**
+	 * Terminate all the workers (jobs are then executed locally).
+	 */
+	void shutdown();
+};
+
+/**
+ * Storage of the visited states of a search.
+ */
+enum StateStorage {
+	FULL_STATES,		///< Complete states (exact)
+	HASH_COMPACTION,	///< 64-bit fingerprints of the states
+	BITSTATE_HASHING,	///< Bits of a fixed-size array set by the states
+	DISK_STATES,		///< Complete states in a file with a cache in memory (exact)
+};
+
+/**
+ * Breadth-first search whose state space is partitioned among the
+ * workers of an engine pool by the hash value of the states.
+ *
+ * Each worker keeps the visited states of its partition and expands
+ * those of the current level, whose successors are exchanged through
+ * the parent process in chunks of bounded size. Only rules are applied
+ * and the pattern cannot have a condition. Solutions are obtained level
+ * by level, but their order within a level may differ from that of the
+ * sequential search.
+ *
+ * Visited states can be stored as fingerprints or as bits in a fixed-size
+ * array to reduce the memory footprint, at the price of possibly omitting
+ * some states, or in files on disk with a cache in memory. The exploration
+ * starts when the first solution is requested.
+ */
+class ParallelSearch {
+public:
+	/**
+	 * Start a parallel search.
+	 *
+	 * @param pool Engine pool, which must not be shut down while the
+	 * search is active (if its workers change, the search fails).
+	 * @param initial Initial term (it is not modified).
+	 * @param type Type of search (number of steps, except @c BRANCH).
+	 * @param target Pattern term.
+	 * @param depth Depth bound (@c -1 for no bound).
+	 */
+	ParallelSearch(EnginePool* pool, EasyTerm* initial, SearchType type,
+	               EasyTerm* target, int depth = -1);
+	~ParallelSearch();
+
+	/**
+	 * Set how the visited states are stored in each partition
+	 * (before the exploration starts).
+	 *
+	 * @param storage Storage mode.
+	 * @param log2Size Base-2 logarithm of the number of bits of the
+	 * array of each partition for @c BITSTATE_HASHING (@c 27 by default),
+	 * or of the number of states cached in memory by each partition for
+	 * @c DISK_STATES (@c 16 by default), where negative means the default.
+	 * @param directory Directory of the state files for @c DISK_STATES
+	 * (the temporary directory of the system if empty).
+	 *
+	 * @return Whether the mode has been set.
+	 */
+	bool setStateStorage(StateStorage storage, int log2Size = -1,
+	                     const std::string &directory = "");
+
+	/**
+	 * Get the estimated probability that some state has been omitted
+	 * due to the compaction of the visited states.
+	 */
+	double getOmissionProbability() const;
+
+	/**
+	 * Whether the exploration is still in progress (it has not
+	 * finished or failed).
+	 */
+	bool isRunning() const;
+
+	/**
+	 * Get the total number of rewrites in all partitions.
+	 */
+	long long getRewriteCount() const;
+
+	/**
+	 * Get the number of distinct states visited in all partitions.
+	 */
+	long long getNrStates() const;
+
+	/**
+	 * Get the depth of the next level to be explored.
+	 */
+	int getDepth() const;
+
+	/**
+	 * Get the number of partitions of the state space.
+	 */
+	int getNrPartitions() const;
+
+	/**
+	 * Get the current progress of the search.
+	 */
+	SearchProgress getProgress() const;
+
+	/**
+	 * Set a callback for the progress of the search, which is checked
+	 * after every level.
+	 *
+	 * @param callback Callback object (that must outlive the search)
+	 * or null to remove the current one.
+	 * @param everyStates Number of new states between calls (non-positive
+	 * to disable this criterion).
+	 * @param everyMillis Milliseconds between calls (non-positive to
+	 * disable this criterion).
+	 */
+	void setProgressCallback(ProgressCallback* callback, long long everyStates = 0,
+	                         double everyMillis = 1000);
+
+	%newobject __next;
+
+	%extend {
+		/**
+		 * Get the next solution of the search.
+		 *
+		 * @return That solution or null pointer if the end has
+		 * been reached.
+		 */
+		EasyTerm* __next() {
+			return $self->next();
+		}
+
+		/**
+		 * Get the next solutions of the search.
+		 *
+		 * @param n Maximum number of solutions.
+		 *
+		 * @return Up to @c n solutions (fewer if the end has been reached).
+		 */
+		std::vector<SearchSolution> next(int n) {
+			std::vector<SearchSolution> solutions;
+
+			for (int i = 0; i < n; i++) {
+				EasyTerm* term = $self->next();
+
+				if (term == nullptr)
+					break;
+
+				solutions.push_back({term, nullptr, nullptr, -1, $self->getRewriteCount()});
+			}
+
+			return solutions;
+		}
+	}
+};
+
+/**
+ * Monte Carlo simulation that executes a number of independent random
+ * walks of bounded length from an initial term, distributed among the
+ * workers of an engine pool.
+ *
+ * At every step, a rule rewrite of the current state is chosen at random
+ * with probability proportional to the weight of its rule. Observables
+ * are unary operators of the module that are reduced to numbers on the
+ * states at the observation steps. Runs that reach a state without
+ * rewrites stay there, so their later observations repeat the last ones.
+ * Each run has its own generator seeded by the simulation seed and the
+ * run number, so results do not depend on the number of workers.
+ */
+class Simulation {
+public:
+	/**
+	 * Create a simulation.
+	 *
+	 * @param pool Engine pool, whose workers must share the module of
+	 * the initial term.
+	 * @param initial Initial term (it is not modified).
+	 * @param maxSteps Maximum number of rule rewrites per run.
+	 */
+	Simulation(EnginePool* pool, EasyTerm* initial, int maxSteps);
+	~Simulation();
+
+	/**
+	 * Set the weight of a rule (@c 1 by default, @c 0 to disable it).
+	 *
+	 * @param rule A rule of the module of the initial term.
+	 * @param weight A non-negative weight.
+	 *
+	 * @return Whether the weight has been set.
+	 */
+	bool setRuleWeight(Rule* rule, double weight);
+
+	/**
+	 * Add an observable.
+	 *
+	 * @param symbol A unary operator of the module whose application
+	 * to the states reduces to a number.
+	 *
+	 * @return Whether the observable has been added.
+	 */
+	bool addObservable(Symbol* symbol);
+
+	/**
+	 * Set the steps where the observables are evaluated (only the
+	 * final step by default, while the step @c 0 is the initial state).
+	 */
+	void setObservationSteps(const std::vector<int> &steps);
+
+	/**
+	 * Execute the runs of the simulation (replacing the previous results).
+	 *
+	 * @param nrRuns Number of runs.
+	 * @param seed Seed of the random choices.
+	 *
+	 * @return Whether all runs have been completed.
+	 */
+	bool run(int nrRuns, long long seed = 0);
+
+	/**
+	 * Get the number of completed runs.
+	 */
+	int getNrRuns() const;
+
+	/**
+	 * Get the number of observables.
+	 */
+	int getNrObservables() const;
+
+	/**
+	 * Get the steps where the observables are evaluated.
+	 */
+	std::vector<int> getObservationSteps() const;
+
+	/**
+	 * Get the values of an observable by run and observation step
+	 * (in row-major order).
+	 */
+	std::vector<double> getObservations(int observable) const;
+
+	/**
+	 * Get the mean of an observable over the runs at each observation step.
+	 */
+	std::vector<double> getMeans(int observable) const;
+
+	/**
+	 * Get the sample variance of an observable over the runs at each
+	 * observation step.
+	 */
+	std::vector<double> getVariances(int observable) const;
+
+	/**
+	 * Get the number of rule rewrites applied by each run.
+	 */
+	std::vector<int> getRunLengths() const;
+
+	/**
+	 * Get the total number of rewrites in all runs.
+	 */
+	long long getRewriteCount() const;
+};
+
+/**
+ * Outcome of a sequential probability ratio test.
+ */
+enum ProbabilityTest {
+	ABOVE_THRESHOLD,	///< The probability is at least the threshold
+	BELOW_THRESHOLD,	///< The probability is below the threshold
+	TEST_UNDECIDED,		///< The maximum number of samples has been reached
+	TEST_FAILED,		///< The samples could not be obtained
+};
+
+/**
+ * Statistical model checker that evaluates an LTL formula on random
+ * executions of bounded length from an initial term, distributed among
+ * the workers of an engine pool.
+ *
+ * Executions are sampled as in a Simulation, and the formula is evaluated
+ * on each sampled trace taking its last state to repeat forever, so the
+ * bound on the number of steps is the bound of the temporal operators.
+ * Atomic propositions are evaluated with the @c _|=_ operator, as in the
+ * model checker of Maude.
+ */
+class StatisticalChecker {
+public:
+	%feature("kwargs") estimate;
+	%feature("kwargs") test;
+
+	/**
+	 * Create a statistical model checker.
+	 *
+	 * @param pool Engine pool, whose workers must share the module of
+	 * the initial term.
+	 * @param initial Initial term (it is not modified).
+	 * @param formula Term of sort @c Formula in the module of the initial term.
+	 * @param maxSteps Maximum number of rule rewrites per execution.
+	 */
+	StatisticalChecker(EnginePool* pool, EasyTerm* initial, EasyTerm* formula, int maxSteps);
+	~StatisticalChecker();
+
+	/**
+	 * Whether the module is prepared for model checking.
+	 */
+	bool isValid() const;
+
+	/**
+	 * Set the weight of a rule (@c 1 by default, @c 0 to disable it).
+	 *
+	 * @param rule A rule of the module of the initial term.
+	 * @param weight A non-negative weight.
+	 *
+	 * @return Whether the weight has been set.
+	 */
+	bool setRuleWeight(Rule* rule, double weight);
+
+	/**
+	 * Estimate the probability that the formula holds, with a number of
+	 * samples given by the Chernoff-Hoeffding bound.
+	 *
+	 * @param epsilon Maximum distance to the actual probability.
+	 * @param delta Probability that the distance exceeds @c epsilon.
+	 * @param seed Seed of the random choices.
+	 *
+	 * @return The estimated probability or @c -1 if the samples could
+	 * not be obtained.
+	 */
+	double estimate(double epsilon = 0.01, double delta = 0.05, long long seed = 0);
+
+	/**
+	 * Test whether the probability that the formula holds is at least
+	 * a threshold with Wald's sequential probability ratio test.
+	 *
+	 * @param threshold Probability threshold.
+	 * @param indifference Half-width of the indifference region around
+	 * the threshold.
+	 * @param alpha Probability of wrongly concluding that the probability
+	 * is below the threshold.
+	 * @param beta Probability of wrongly concluding that the probability
+	 * is above the threshold.
+	 * @param seed Seed of the random choices.
+	 * @param maxSamples Maximum number of samples (@c -1 for no bound).
+	 */
+	ProbabilityTest test(double threshold, double indifference = 0.01, double alpha = 0.05,
+	                     double beta = 0.05, long long seed = 0, long long maxSamples = -1);
+
+	/**
+	 * Get the number of samples used by the last estimation or test.
+	 */
+	long long getNrSamples() const;
+
+	/**
+	 * Get the number of samples where the formula holds.
+	 */
+	long long getNrSatisfied() const;
+
+	/**
+	 * Get the proportion of samples where the formula holds.
+	 */
+	double getProbability() const;
+
+	/**
+	 * Get the total number of rewrites in all samples.
+	 */
+	long long getRewriteCount() const;
+};
@@ -0,0 +1,102 @@
+//
+//	Interface to the recorder of rewrite steps
+//
+
+%{
+#include "trace_recorder.hh"
+%}
+
+/**
+ * Recorder of the rewrite steps executed while it is active by the
+ * reduce, rewrite, frewrite, erewrite, srewrite, and search methods
+ * of terms and by rewriters (including lazy iterators advanced while
+ * the recorder is active).
+ *
+ * Steps are kept in a ring buffer of fixed capacity, where the oldest
+ * ones are dropped. Each step records the statement, the redex, and the
+ * result of the rewrite, which can be inspected after the run. Recording
+ * has to enable the slow path of the rewriting engine, which has a
+ * moderate cost, but no text is produced.
+ */
+class TraceRecorder {
+public:
+	/**
+	 * Kinds of steps.
+	 */
+	enum StepKind {
+		EQUATION,	///< Application of an equation.
+		BUILTIN,	///< Built-in equational rewrite (without equation).
+		MEMOIZED,	///< Equational rewrite using the memo table.
+		RULE,		///< Application of a rule.
+		NONE = -1,	///< Invalid step index.
+	};
+
+	/**
+	 * Create a trace recorder.
+	 *
+	 * @param capacity Maximum number of steps kept.
+	 * @param withEquations Whether equational steps are recorded.
+	 */
+	TraceRecorder(int capacity, bool withEquations = true);
+	~TraceRecorder();
+
+	%newobject getRedex;
+	%newobject getResult;
+
+	/**
+	 * Start recording.
+	 */
+	void activate();
+
+	/**
+	 * Stop recording.
+	 */
+	void deactivate();
+
+	/**
+	 * Whether the recorder is active.
+	 */
+	bool isActive() const;
+
+	/**
+	 * Get the number of steps kept in the buffer.
+	 */
+	int size() const;
+
+	/**
+	 * Get the number of steps recorded, including those dropped.
+	 */
+	long long getTotalSteps() const;
+
+	/**
+	 * Get the kind of a step.
+	 *
+	 * @param index Index of the step (from @c 0 for the oldest kept step).
+	 */
+	StepKind getKind(int index) const;
+
+	/**
+	 * Get the equation applied in a step (or null).
+	 */
+	Equation* getEquation(int index) const;
+
+	/**
+	 * Get the rule applied in a step (or null).
+	 */
+	Rule* getRule(int index) const;
+
+	/**
+	 * Get the redex of a step (or null if the index is not valid).
+	 */
+	EasyTerm* getRedex(int index) const;
+
+	/**
+	 * Get the result of a step (or null if it has not finished).
+	 */
+	EasyTerm* getResult(int index) const;
+
+	/**
+	 * Remove all steps from the buffer.
+	 */
+	void clear();
+};
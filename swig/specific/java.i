@@ -53,9 +53,15 @@
 %makeIterable(MatchSearchState, Substitution);
 %makeIterable(RewriteSequenceSearch, Term);
 %makeIterable(StrategySequenceSearch, Term);
+%makeIterable(BestFirstSearch, Term);
 %makeIterable(VariantSearch, TermSubstitutionPair);
 %makeIterable(NarrowingSequenceSearch3, Term);
 
+//
+// Defined in pool.i
+
+%makeIterable(ParallelSearch, Term);
+
 // DagArgumentIterator
 
 %typemap(javaimports) DagArgumentIterator %{
@@ -11,6 +11,24 @@
 __version__ = '1.5.0'
 %}
 
+%pythonbegin %{
+import os as _os
+%}
+
+// The interpreter lock is released while the long-running operations
+// execute, so that they can be cancelled from other threads (callbacks
+// take it back, but Maude must not be used by several threads at once)
+%nothreadallow;
+%threadallow reduce;
+%threadallow rewrite;
+%threadallow frewrite;
+%threadallow erewrite;
+%threadallow reduceWithStats;
+%threadallow rewriteWithStats;
+%threadallow frewriteWithStats;
+%threadallow __next;
+%threadallow modelCheck;
+
 %define %makeIterable(CLASS)
 %extend CLASS {
 %pythoncode %{
@@ -50,7 +68,8 @@ __version__ = '1.5.0'
 	%feature("shadow") %searchSignature(1) %{ %}
 
 	%feature("shadow") %searchSignature(0) %{
-		def search(self, type, target, strategy=None, condition=None, depth=-1):
+		def search(self, type, target, strategy=None, condition=None, depth=-1, heuristic=None,
+		           astar=False, checkpoint=None):
 			r"""
 			Search states that match into a given pattern and satisfy a given condition
 			by rewriting from this term.
@@ -65,8 +84,19 @@ __version__ = '1.5.0'
 			:param condition: Condition that solutions must satisfy.
 			:type depth: int, optional
 			:param depth: Depth bound
-
-			:rtype: either :py:class:`StrategySequenceSearch` if a strategy is provided or :py:class:`RewriteSequenceSearch`
+			:type heuristic: :py:class:`Symbol` or :py:class:`SearchHeuristic`, optional
+			:param heuristic: Heuristic for a best-first search (without strategy).
+			:type astar: bool, optional
+			:param astar: Whether the depth is added to the heuristic (A* search).
+			:type checkpoint: str, optional
+			:param checkpoint: Path of a checkpoint file (without strategy). The search is
+			  resumed from it if it exists (raising :py:exc:`ValueError` if it
+			  cannot be restored), and it can be saved there with
+			  :py:meth:`BestFirstSearch.checkpoint`.
+
+			:rtype: either :py:class:`StrategySequenceSearch` if a strategy is provided,
+			  :py:class:`BestFirstSearch` if a heuristic or checkpoint is provided,
+			  or :py:class:`RewriteSequenceSearch`
 			:return: An object to iterate through matches.
 			"""
 			# Fix the case where a condition and not a strategy has been specified
@@ -78,6 +108,18 @@ __version__ = '1.5.0'
 			if condition is None:
 				condition = _maude.cvar.Term_NO_CONDITION
 
+			if heuristic is not None or checkpoint is not None:
+				if strategy is not None:
+					raise ValueError('a best-first search cannot be controlled by a strategy')
+				search = BestFirstSearch(self, type, target, condition, depth)
+				if heuristic is not None:
+					search.setHeuristic(heuristic, astar)
+				# An invalid checkpoint must not be overwritten by a new search
+				if checkpoint is not None and _os.path.exists(checkpoint) \
+				   and not search.restore(checkpoint):
+					raise ValueError(f'cannot restore the search from {checkpoint}')
+				return search
+
 			if strategy is not None:
 				return _maude.Term__search(self, type, target, strategy, condition, depth)
 			else:
@@ -88,12 +130,42 @@ __version__ = '1.5.0'
 		def __eq__(self, other):
 			return other is not None and self.equal(other)
 
+		def __reduce__(self):
+			return _unpickle_term, (self.serialize(), )
+
 		__float__ = toFloat
 		__int__ = toInt
 		__hash__ = hash
 	%}
 }
 
+// Serialized terms are bytes objects
+
+%typemap(out) std::string serialize {
+	$result = PyBytes_FromStringAndSize($1.data(), $1.size());
+}
+
+%typemap(in) const std::string &serialized (std::string temp) {
+	char* buffer;
+	Py_ssize_t length;
+
+	if (PyBytes_AsStringAndSize($input, &buffer, &length) < 0)
+		SWIG_fail;
+
+	temp.assign(buffer, length);
+	$1 = &temp;
+}
+
+%typemap(typecheck) const std::string &serialized {
+	$1 = PyBytes_Check($input) ? 1 : 0;
+}
+
+%pythoncode %{
+def _unpickle_term(data):
+	"""Rebuild a pickled term (its module is looked up by name)"""
+	return Term.deserialize(None, data)
+%}
+
 %extend StrategicSearch {
 %pythoncode %{
 	def __iter__(self):
@@ -136,17 +208,7 @@ __version__ = '1.5.0'
 		:return: A list interleaving terms and rules that connect
 		  them from the initial to the given state.
 		"""
-		parent = self.getStateParent(stateNr)
-
-		if parent < 0:
-			path = [self.getStateTerm(stateNr)]
-		else:
-			path = self.pathTo(parent)
-
-			path.append(self.getRule(stateNr))
-			path.append(self.getStateTerm(stateNr))
-
-		return path
+		return self.getPath(stateNr)
 
 	def __next__(self):
 		term = self.__next()
@@ -172,17 +234,7 @@ __version__ = '1.5.0'
 		:return: A list interleaving terms and transitions that connect
 		  them from the initial to the given state.
 		"""
-		parent = self.getStateParent(stateNr)
-
-		if parent < 0:
-			path = [self.getStateTerm(stateNr)]
-		else:
-			path = self.pathTo(parent)
-
-			path.append(self.getTransition(stateNr))
-			path.append(self.getStateTerm(stateNr))
-
-		return path
+		return self.getPath(stateNr)
 
 	def __next__(self):
 		term = self.__next()
@@ -193,6 +245,81 @@ __version__ = '1.5.0'
 %}
 }
 
+%extend BestFirstSearch {
+%pythoncode %{
+	def __iter__(self):
+		return self
+
+	def __next__(self):
+		term = self.__next()
+		if term is None:
+			raise StopIteration
+		stateNr = self.getStateNr()
+		return term, self.getSubstitution(), lambda: self.getPath(stateNr), self.getRewriteCount()
+%}
+}
+
+%extend CancellationToken {
+%pythoncode %{
+	def __enter__(self):
+		self.activate()
+		return self
+
+	def __exit__(self, exc_type, exc_value, traceback):
+		self.deactivate()
+%}
+}
+
+%extend TraceRecorder {
+%pythoncode %{
+	__len__ = size
+
+	def __enter__(self):
+		self.activate()
+		return self
+
+	def __exit__(self, exc_type, exc_value, traceback):
+		self.deactivate()
+%}
+}
+
+%makeIterable(ParallelSearch);
+
+%extend TermInterner {
+%pythoncode %{
+	__len__ = size
+%}
+}
+
+%extend EasyTermSet {
+%pythoncode %{
+	__len__ = size
+	__contains__ = contains
+
+	def __iter__(self):
+		return iter(self.getTerms())
+%}
+}
+
+%extend EasyTermMap {
+%pythoncode %{
+	__len__ = size
+	__contains__ = contains
+	__setitem__ = set
+
+	def __getitem__(self, term):
+		if not self.contains(term):
+			raise KeyError(term)
+		return self.get(term)
+
+	def __iter__(self):
+		return iter(self.getKeys())
+
+	def items(self):
+		return zip(self.getKeys(), self.getValues())
+%}
+}
+
 %extend EasyArgumentIterator {
 %pythoncode %{
 	def __iter__(self):
@@ -570,10 +697,38 @@ bool convertVector(PyObject* input, Vector<T*>* &vect, swig_type_info* swig_elem
 	return *&$1 == nullptr ? Py_None : convert2Py(**&$1);
 }
 
+%typemap(out) std::vector<double> {
+	return &$1 == nullptr ? Py_None : convert2Py(*&$1);
+}
+
+%typemap(out) std::vector<double>* {
+	return *&$1 == nullptr ? Py_None : convert2Py(**&$1);
+}
+
+%typemap(out) std::vector<std::string>* {
+	return *&$1 == nullptr ? Py_None : convert2Py(**&$1);
+}
+
 %typemap(out) std::vector<View*> {
 	return &$1 == nullptr ? Py_None : convert2Py(*&$1);
 }
 
+%typemap(out) std::vector<std::pair<EasyTerm*, int>> {
+	return &$1 == nullptr ? Py_None : convert2Py(*&$1);
+}
+
+%typemap(out) std::vector<std::vector<EasyTerm*>> {
+	return &$1 == nullptr ? Py_None : convert2Py(*&$1);
+}
+
+%typemap(out) std::vector<SearchSolution> {
+	return &$1 == nullptr ? Py_None : convert2Py(*&$1);
+}
+
+%typemap(out) std::vector<PathStep> {
+	return &$1 == nullptr ? Py_None : convert2Py(*&$1);
+}
+
 // Instruction so that ConditionFragments returned by functions are
 // automatically casted to the corresponding subtype
 
@@ -601,24 +756,9 @@ void install_target_signal_handlers(bool handledByMaude) { }
 #include <signal.h>
 #include "userLevelRewritingContext.hh"
 
-//
-// Hack to make Ctrl+C abort the current calculation without necessarily
-// terminating the program and without entering in an unusable debugger.
-// This implies setting the abortFlag of UserLevelRewritingContext, which
-// is a private static attribute. The correct way would be subclassing
-// UserLevelRewritingContext and redefining its virtual methods.
-//
-
-void setMaudeAbortFlags();
-
-template<bool* N>
-struct SetAbortFlagsHack {
-	friend void setMaudeAbortFlags() {
-		*N = true;
-	}
-};
-
-template struct SetAbortFlagsHack<&UserLevelRewritingContext::abortFlag>;
+// Ctrl+C aborts the current calculation without necessarily terminating
+// the program and without entering in an unusable debugger (the abort
+// flag is set with setMaudeAbortFlags from cancellation.hh)
 
 // Signal handler for SIGINT (Ctrl+C)
 
@@ -644,7 +784,9 @@ void pysigother_handler(int sig) {
 
 	// Make Python execute the actual handler and terminate
 	// if an exception occurs during its execution
-	if (PyErr_CheckSignals() == -1)
+	// (only if the interpreter lock is held, since it may have been
+	// released by a long-running operation)
+	if (PyGILState_Check() && PyErr_CheckSignals() == -1)
 		_exit(0);
 }
 
@@ -0,0 +1,196 @@
+//
+//	Interface to tables of terms
+//
+
+%{
+#include "term_tables.hh"
+%}
+
+%rename (TermSet) EasyTermSet;
+%rename (TermMap) EasyTermMap;
+
+/**
+ * Table mapping structurally equal terms of a module to the same
+ * integer handle, so that equality becomes integer comparison.
+ *
+ * The hash value of each term is computed once when it is interned.
+ * Interned terms are not affected by later changes to the original
+ * term objects.
+ */
+class TermInterner {
+public:
+	/**
+	 * Create an empty table for the terms of a module.
+	 */
+	TermInterner(VisibleModule* module);
+	~TermInterner();
+
+	%newobject getTerm;
+
+	/**
+	 * Get the handle of a term, inserting it if not already present.
+	 *
+	 * @param term A term of the module of the table.
+	 *
+	 * @return The handle or @c -1 if the term belongs to another module.
+	 */
+	int intern(EasyTerm* term);
+
+	/**
+	 * Intern many terms at once.
+	 *
+	 * @param terms Terms of the module of the table.
+	 *
+	 * @return Their handles.
+	 */
+	std::vector<int> internMany(const std::vector<EasyTerm*> &terms);
+
+	/**
+	 * Get the handle of a term without inserting it.
+	 *
+	 * @return The handle or @c -1 if the term is not in the table.
+	 */
+	int find(EasyTerm* term);
+
+	/**
+	 * Get the canonical term for a handle.
+	 *
+	 * @return The term or null if the handle is not valid.
+	 */
+	EasyTerm* getTerm(int handle) const;
+
+	/**
+	 * Get the hash value of the term for a handle.
+	 */
+	size_t getHash(int handle) const;
+
+	/**
+	 * Get the number of distinct terms in the table.
+	 */
+	int size() const;
+};
+
+/**
+ * Set of terms of a module.
+ *
+ * Terms are compared structurally using their hash values. Inserted
+ * terms are not affected by later changes to the original term objects.
+ */
+class EasyTermSet {
+public:
+	/**
+	 * Create an empty set for the terms of a module.
+	 */
+	EasyTermSet(VisibleModule* module);
+	~EasyTermSet();
+
+	/**
+	 * Insert a term in the set.
+	 *
+	 * @return Whether the term was not already in the set.
+	 */
+	bool insert(EasyTerm* term);
+
+	/**
+	 * Check whether a term is in the set.
+	 */
+	bool contains(EasyTerm* term);
+
+	/**
+	 * Insert many terms at once.
+	 *
+	 * @return For each term, whether it was not already in the set.
+	 */
+	std::vector<int> insertMany(const std::vector<EasyTerm*> &terms);
+
+	/**
+	 * Check whether many terms are in the set.
+	 *
+	 * @return For each term, whether it is in the set.
+	 */
+	std::vector<int> containsMany(const std::vector<EasyTerm*> &terms);
+
+	/**
+	 * Get the terms in the set (in insertion order).
+	 */
+	std::vector<EasyTerm*> getTerms() const;
+
+	/**
+	 * Get the number of terms in the set.
+	 */
+	int size() const;
+
+	/**
+	 * Remove all terms from the set.
+	 */
+	void clear();
+};
+
+/**
+ * Map from terms of a module to integers.
+ *
+ * Terms are compared structurally using their hash values. Integer
+ * values can be used as indices to associate arbitrary data to terms.
+ */
+class EasyTermMap {
+public:
+	/**
+	 * Create an empty map for the terms of a module.
+	 */
+	EasyTermMap(VisibleModule* module);
+	~EasyTermMap();
+
+	/**
+	 * Set the value associated to a term.
+	 */
+	void set(EasyTerm* term, int value);
+
+	/**
+	 * Get the value associated to a term.
+	 *
+	 * @param term The term.
+	 * @param defaultValue Value returned if the term is not in the map.
+	 */
+	int get(EasyTerm* term, int defaultValue = -1);
+
+	/**
+	 * Check whether a term is in the map.
+	 */
+	bool contains(EasyTerm* term);
+
+	/**
+	 * Set the values associated to many terms at once.
+	 *
+	 * @param terms The terms.
+	 * @param values The values for each term (in the same order).
+	 */
+	void setMany(const std::vector<EasyTerm*> &terms, const std::vector<int> &values);
+
+	/**
+	 * Get the values associated to many terms at once.
+	 *
+	 * @param terms The terms.
+	 * @param defaultValue Value returned for the terms not in the map.
+	 */
+	std::vector<int> getMany(const std::vector<EasyTerm*> &terms, int defaultValue = -1);
+
+	/**
+	 * Get the keys of the map (in insertion order).
+	 */
+	std::vector<EasyTerm*> getKeys() const;
+
+	/**
+	 * Get the values of the map (in the same order as the keys).
+	 */
+	std::vector<int> getValues() const;
+
+	/**
+	 * Get the number of entries in the map.
+	 */
+	int size() const;
+
+	/**
+	 * Remove all entries from the map.
+	 */
+	void clear();
+};
@@ -12,6 +12,7 @@
 #include "narrowingSequenceSearch3.hh"
 #include "rewriteSearchState.hh"
 #include "variableDagNode.hh"
+#include "rewriter.hh"
 %}
 
 %import "config.h"
@@ -21,9 +22,42 @@
 //	(defined and documented in easyTerm.cc/hh)
 //
 
+%immutable RewriteStats;
+
+/**
+ * Statistics of a rewriting operation.
+ */
+struct RewriteStats {
+	long long total;		///< Total number of rewrites.
+	long long equational;		///< Number of equational rewrites (including built-in ones).
+	long long rule;			///< Number of rule rewrites.
+	long long membership;		///< Number of membership axiom applications.
+	long long narrowing;		///< Number of narrowing steps.
+	long long variantNarrowing;	///< Number of variant narrowing steps.
+	long long gcRuns;		///< Number of garbage collections.
+	double cpuTime;			///< Processor time in seconds.
+	double realTime;		///< Wall-clock time in seconds.
+};
+
+%immutable SearchSolution;
+
+/**
+ * Solution of a search in a page of results.
+ *
+ * Fields that do not apply to the search are null or @c -1.
+ */
+struct SearchSolution {
+	EasyTerm* term;			///< Solution term.
+	EasySubstitution* substitution;	///< Matching substitution or unifier.
+	EasySubstitution* unifier;	///< Variant unifier (only for narrowing).
+	int stateNr;			///< Number of the solution state in the search graph.
+	long long rewrites;		///< Number of rewrites until the solution.
+};
+
 %rename (Term) EasyTerm;
 %rename (Substitution) EasySubstitution;
 %rename (ArgumentIterator) EasyArgumentIterator;
+%rename (Rewriter) EasyRewriter;
 %rename (NarrowingSequenceSearch) NarrowingSequenceSearch3;
 
 
@@ -86,6 +120,24 @@ enum NarrowingFlags {
 	FILTER = VariantUnificationProblem::FILTER_VARIANT_UNIFIERS,
 };
 
+/**
+ * Flat preorder representation of a term.
+ *
+ * The entries at the same position of the symbols, arities, numbers and
+ * texts sequences describe a node of the term. Subterms shared in the DAG
+ * are only expanded the first time they are found, and referenced later.
+ */
+struct FlatTerm {
+	%immutable;
+	/// Index of the symbol in the getSymbols list of its module, or
+	/// -(k+1) for a reference to the subterm already expanded at position k.
+	std::vector<int> symbols;
+	std::vector<int> arities;		///< Number of arguments of each node.
+	std::vector<double> numbers;		///< Numeric payload of built-in constants (NaN if none).
+	std::vector<int> texts;			///< Position of the textual payload in strings (-1 if none).
+	std::vector<std::string> strings;	///< Distinct textual payloads.
+};
+
 /**
  * Maude term with its associated operations.
  */
@@ -100,6 +152,8 @@ public:
 	%newobject search;
 	%newobject arguments;
 	%newobject copy;
+	%newobject deserialize;
+	%newobject flatten;
 
 	// Keyword arguments are used when available for some of the
 	// methods of this class to avoid writing unnecessary arguments
@@ -152,6 +206,10 @@ public:
 	/**
 	 * Reduce this term.
 	 *
+	 * If the normal form cache of the module is enabled and the term
+	 * is ground, the normal form may be obtained from the cache (in
+	 * which case no rewrites are reported).
+	 *
 	 * @return The total number of rewrites.
 	 */
 	int reduce();
@@ -175,6 +233,65 @@ public:
 	 */
 	int frewrite(int bound = -1, int gas = -1);
 
+	%extend {
+		/**
+		 * Reduce this term and obtain the statistics of the call.
+		 */
+		RewriteStats reduceWithStats() {
+			RewriteStats stats;
+			$self->reduce(&stats);
+			return stats;
+		}
+
+		/**
+		 * Rewrite a term following the semantics of the @c rewrite
+		 * command and obtain the statistics of the call.
+		 *
+		 * @param bound An upper bound on the number of rule rewrites.
+		 */
+		RewriteStats rewriteWithStats(int bound = -1) {
+			RewriteStats stats;
+			$self->rewrite(bound, &stats);
+			return stats;
+		}
+
+		/**
+		 * Rewrite a term following the semantics of the @c frewrite
+		 * command and obtain the statistics of the call.
+		 *
+		 * @param bound An upper bound on the number of rule rewrites.
+		 * @param gas An upper bound on the number of rule rewrites per position.
+		 */
+		RewriteStats frewriteWithStats(int bound = -1, int gas = -1) {
+			RewriteStats stats;
+			$self->frewrite(bound, gas, &stats);
+			return stats;
+		}
+	}
+
+	/**
+	 * Reduce many terms at once (in place).
+	 *
+	 * Terms are grouped by module, and the module bookkeeping and the
+	 * rewriting context are shared by all the terms in each group.
+	 *
+	 * @param terms The terms to be reduced.
+	 *
+	 * @return The total number of rewrites for each term.
+	 */
+	static std::vector<int> reduceMany(const std::vector<EasyTerm*> &terms);
+
+	/**
+	 * Rewrite many terms at once (in place) following the semantics
+	 * of the @c rewrite command.
+	 *
+	 * @param terms The terms to be rewritten.
+	 * @param bound An upper bound on the number of rule rewrites per term.
+	 *
+	 * @return The total number of rewrites for each term.
+	 */
+	static std::vector<int> rewriteMany(const std::vector<EasyTerm*> &terms, int bound = -1);
+
 	/**
 	 * Rewrite a term following the semantics of the @c erewrite command.
 	 *
@@ -361,6 +478,36 @@ public:
 	 */
 	std::string toLatex();
 
+	/**
+	 * Serialize this term into a compact binary representation
+	 * that preserves sharing and can be read with deserialize.
+	 *
+	 * @return The serialized term (empty if it contains unsupported
+	 * built-in constants).
+	 */
+	std::string serialize();
+
+	/**
+	 * Rebuild a term from its serialized representation.
+	 *
+	 * @param module Module where the term is built or null to look it
+	 * up by the name stored in the serialized data.
+	 * @param serialized The serialized representation of the term.
+	 *
+	 * @return The term or null if the data is not valid.
+	 */
+	static EasyTerm* deserialize(VisibleModule* module, const std::string &serialized);
+
+	/**
+	 * Export this term as a flat preorder sequence of nodes, without
+	 * creating intermediate term objects.
+	 *
+	 * Floating-point numbers are given in numbers, strings, quoted
+	 * identifiers and variable names in texts, and the exponent of
+	 * iterated symbols and the value of SMT numbers in both.
+	 */
+	FlatTerm* flatten();
+
 	%streamBasedPrint;
 };
 
@@ -385,6 +532,13 @@ public:
 			return $self->getContext()->getTotalCount();
 		}
 
+		/**
+		 * Get the rewrite counts until this point of the search.
+		 */
+		RewriteStats getStats() {
+			return StatsRecorder::fromContext($self->getContext());
+		}
+
 		/**
 		 * Get the next solution for the strategic search.
 		 *
@@ -395,11 +549,96 @@ public:
 			DagNode* d = $self->findNextSolution();
 			return d == nullptr ? nullptr : new EasyTerm(d);
 		}
+
+		/**
+		 * Get the next solutions for the strategic search.
+		 *
+		 * @param n Maximum number of solutions.
+		 *
+		 * @return Up to @c n solutions (fewer if the end has been reached).
+		 */
+		std::vector<SearchSolution> next(int n) {
+			std::vector<SearchSolution> solutions;
+
+			for (int i = 0; i < n; i++) {
+				DagNode* d = $self->findNextSolution();
+
+				if (d == nullptr)
+					break;
+
+				solutions.push_back({new EasyTerm(d), nullptr, nullptr, -1,
+				                     $self->getContext()->getTotalCount()});
+			}
+
+			return solutions;
+		}
 	}
 
 	%unprotectDestructor(StrategicSearch);
 };
 
+/**
+ * Rewriting session that keeps its rewriting context alive between
+ * calls, so that a long rewrite can be executed in slices.
+ *
+ * The scheduling of rules and the fairness state of @c frewrite are
+ * preserved between steps, so that rewriting in slices is equivalent
+ * to the @c continue command of the interpreter.
+ */
+class EasyRewriter {
+public:
+	/**
+	 * Rewriting modes.
+	 */
+	enum Mode {
+		REWRITE,	///< Following the semantics of the @c rewrite command.
+		FREWRITE,	///< Following the semantics of the @c frewrite command.
+	};
+
+	/**
+	 * Start a rewriting session.
+	 *
+	 * @param term Initial term (it is not modified).
+	 * @param mode Rewriting mode.
+	 * @param gas An upper bound on the number of rule rewrites per position
+	 * in a traversal (only for @c FREWRITE).
+	 */
+	EasyRewriter(EasyTerm* term, Mode mode = REWRITE, int gas = -1);
+	~EasyRewriter();
+
+	%newobject getState;
+
+	/**
+	 * Execute more rule rewrites.
+	 *
+	 * @param steps An upper bound on the number of rule rewrites
+	 * (@c -1 for no bound).
+	 *
+	 * @return The current state and the number of rewrites in this step.
+	 */
+	std::pair<EasyTerm*, int> step(int steps = -1);
+
+	/**
+	 * Get the current state.
+	 */
+	EasyTerm* getState() const;
+
+	/**
+	 * Whether no more rule rewrites can be applied.
+	 */
+	bool isFinished() const;
+
+	/**
+	 * Get the total number of rewrites since the start of the session.
+	 */
+	int getRewriteCount() const;
+
+	/**
+	 * Get the rewrite counts since the start of the session.
+	 */
+	RewriteStats getStats() const;
+};
+
 /**
  * Substitution (mapping from variables to terms).
  */
@@ -511,6 +750,25 @@ public:
 					 : nullptr;
 		}
 
+		/**
+		 * Get the next matches.
+		 *
+		 * @param n Maximum number of matches.
+		 *
+		 * @return Up to @c n matches (fewer if the end has been reached).
+		 */
+		std::vector<SearchSolution> next(int n) {
+			std::vector<SearchSolution> solutions;
+
+			for (int i = 0; i < n && $self->findNextMatch(); i++)
+				solutions.push_back({nullptr, new EasySubstitution($self->getContext(),
+				                                                   $self->getPattern(),
+				                                                   $self->getExtensionInfo()),
+				                     nullptr, -1, -1});
+
+			return solutions;
+		}
+
 		/**
 		 * Get the context of the match filled with the given term.
 		 *
@@ -545,6 +803,13 @@ public:
 			return $self->getContext()->getTotalCount();
 		}
 
+		/**
+		 * Get the rewrite counts until this point of the search.
+		 */
+		RewriteStats getStats() {
+			return StatsRecorder::fromContext($self->getContext());
+		}
+
 		/**
 		 * Get the matching substitution of the solution into the pattern.
 		 */
@@ -574,6 +839,51 @@ public:
 			return new EasyTerm($self->getStateDag(stateNr));
 		}
 
+		/**
+		 * Get the path from the initial state to the given one.
+		 *
+		 * @param stateNr The number of a state in the search graph
+		 * or -1 for the current one.
+		 *
+		 * @return The states of the path with the rules leading to them.
+		 */
+		std::vector<PathStep> getPath(int stateNr = -1) {
+			return getPath(*$self, stateNr);
+		}
+
+		/**
+		 * Get the state numbers of the path from the initial state
+		 * to the given one.
+		 *
+		 * @param stateNr The number of a state in the search graph
+		 * or -1 for the current one.
+		 */
+		std::vector<int> getPathStates(int stateNr = -1) {
+			return getPathStates(*$self, stateNr);
+		}
+
+		/**
+		 * Get the current progress of the search.
+		 */
+		SearchProgress getProgress() {
+			return getMonitor($self)->getProgress();
+		}
+
+		/**
+		 * Set a callback for the progress of the search, which is
+		 * checked at every rule rewrite while the search runs.
+		 *
+		 * @param callback Callback object (that must outlive the search)
+		 * or null to remove the current one.
+		 * @param everyStates Number of new states between calls
+		 * (non-positive to disable this criterion).
+		 * @param everyMillis Milliseconds between calls (non-positive
+		 * to disable this criterion).
+		 */
+		void setProgressCallback(ProgressCallback* callback, long long everyStates = 0,
+		                         double everyMillis = 1000) {
+			getMonitor($self)->setCallback(callback, everyStates, everyMillis);
+		}
 
 		/**
 		 * Get the next match.
@@ -581,9 +891,33 @@ public:
 		 * @return A term or a null pointer if there is no more matches.
 		 */
 		EasyTerm* __next() {
+			SearchMonitor::Scope scope(findMonitor($self));
 			bool hasNext = $self->findNextMatch();
 			return hasNext ? new EasyTerm($self->getStateDag($self->getStateNr())) : nullptr;
 		}
+
+		/**
+		 * Get the next matches.
+		 *
+		 * @param n Maximum number of matches.
+		 *
+		 * @return Up to @c n solutions (fewer if the end has been reached).
+		 */
+		std::vector<SearchSolution> next(int n) {
+			SearchMonitor::Scope scope(findMonitor($self));
+			std::vector<SearchSolution> solutions;
+
+			for (int i = 0; i < n && $self->findNextMatch(); i++) {
+				int stateNr = $self->getStateNr();
+				solutions.push_back({new EasyTerm($self->getStateDag(stateNr)),
+				                     new EasySubstitution($self->getSubstitution(),
+				                                          $self->getGoal(), nullptr),
+				                     nullptr, stateNr,
+				                     $self->getContext()->getTotalCount()});
+			}
+
+			return solutions;
+		}
 	}
 
 	/**
@@ -623,6 +957,13 @@ public:
 			return $self->getContext()->getTotalCount();
 		}
 
+		/**
+		 * Get the rewrite counts until this point of the search.
+		 */
+		RewriteStats getStats() {
+			return StatsRecorder::fromContext($self->getContext());
+		}
+
 		/**
 		 * Get the matching substitution of the solution into the pattern.
 		 */
@@ -655,6 +996,29 @@ public:
 			return new EasyTerm($self->getStateDag(stateNr));
 		}
 
+		/**
+		 * Get the path from the initial state to the given one.
+		 *
+		 * @param stateNr The number of a state in the search graph
+		 * or -1 for the current one.
+		 *
+		 * @return The states of the path with the transitions leading to them.
+		 */
+		std::vector<PathStep> getPath(int stateNr = -1) {
+			return getPath(*$self, stateNr);
+		}
+
+		/**
+		 * Get the state numbers of the path from the initial state
+		 * to the given one.
+		 *
+		 * @param stateNr The number of a state in the search graph
+		 * or -1 for the current one.
+		 */
+		std::vector<int> getPathStates(int stateNr = -1) {
+			return getPathStates(*$self, stateNr);
+		}
+
 		/**
 		 * Get the next strategy to be executed from the given state.
 		 *
@@ -666,15 +1030,62 @@ public:
 					? $self->getStateNr() : stateNr);
 		}
 
+		/**
+		 * Get the current progress of the search.
+		 */
+		SearchProgress getProgress() {
+			return getMonitor($self)->getProgress();
+		}
+
+		/**
+		 * Set a callback for the progress of the search, which is
+		 * checked at every rule rewrite while the search runs.
+		 *
+		 * @param callback Callback object (that must outlive the search)
+		 * or null to remove the current one.
+		 * @param everyStates Number of new states between calls
+		 * (non-positive to disable this criterion).
+		 * @param everyMillis Milliseconds between calls (non-positive
+		 * to disable this criterion).
+		 */
+		void setProgressCallback(ProgressCallback* callback, long long everyStates = 0,
+		                         double everyMillis = 1000) {
+			getMonitor($self)->setCallback(callback, everyStates, everyMillis);
+		}
+
 		/**
 		 * Get the next match.
 		 *
 		 * @return A term or a null pointer if there is no more matches.
 		 */
 		EasyTerm* __next() {
+			SearchMonitor::Scope scope(findMonitor($self));
 			bool hasNext = $self->findNextMatch();
 			return hasNext ? new EasyTerm($self->getStateDag($self->getStateNr())) : nullptr;
 		}
+
+		/**
+		 * Get the next matches.
+		 *
+		 * @param n Maximum number of matches.
+		 *
+		 * @return Up to @c n solutions (fewer if the end has been reached).
+		 */
+		std::vector<SearchSolution> next(int n) {
+			SearchMonitor::Scope scope(findMonitor($self));
+			std::vector<SearchSolution> solutions;
+
+			for (int i = 0; i < n && $self->findNextMatch(); i++) {
+				int stateNr = $self->getStateNr();
+				solutions.push_back({new EasyTerm($self->getStateDag(stateNr)),
+				                     new EasySubstitution($self->getSubstitution(),
+				                                          $self->getGoal(), nullptr),
+				                     nullptr, stateNr,
+				                     $self->getContext()->getTotalCount()});
+			}
+
+			return solutions;
+		}
 	}
 
 	/**
@@ -695,6 +1106,281 @@ public:
 	%unprotectDestructor(StrategySequenceSearch);
 };
 
+%feature("director") SearchHeuristic;
+
+/**
+ * Heuristic function defined in the external language.
+ */
+struct SearchHeuristic {
+	/**
+	 * Method called to evaluate a state.
+	 *
+	 * @param state The state term (only valid during the call).
+	 *
+	 * @return The estimated distance to a solution (lower is better,
+	 * while NaN stops the search with a warning).
+	 */
+	virtual double evaluate(EasyTerm* state) = 0;
+	virtual ~SearchHeuristic() {};
+};
+
+/**
+ * An iterator through the solutions of a best-first search, which
+ * explores the state with the lowest priority first.
+ *
+ * The priority is given by a heuristic, either a unary operator of the
+ * module reduced on every state to a number or an external function,
+ * plus the depth of the state for A* search. Without heuristic, states
+ * are explored in breadth-first order. The size of the frontier and the
+ * number of stored states can be bounded, dropping states.
+ */
+class BestFirstSearch {
+public:
+	/**
+	 * Create a best-first search.
+	 *
+	 * @param initial Initial term (it is not modified).
+	 * @param type Type of search (@c BRANCH is not supported).
+	 * @param target Pattern term.
+	 * @param condition Condition that solutions must satisfy.
+	 * @param depth Depth bound (@c -1 for no bound).
+	 */
+	BestFirstSearch(EasyTerm* initial, SearchType type, EasyTerm* target,
+	                const Vector<ConditionFragment*> &condition = EasyTerm::NO_CONDITION,
+	                int depth = -1);
+
+	%newobject getSubstitution;
+	%newobject getStateTerm;
+	%newobject __next;
+
+	/**
+	 * Set the heuristic as a unary operator of the module, which is
+	 * reduced on every state to a number (before the search starts).
+	 * Floats, integers and SMT numbers are accepted, and the search
+	 * stops with a warning on any other value.
+	 *
+	 * @param symbol Heuristic operator.
+	 * @param astar Whether the depth is added to the heuristic value.
+	 *
+	 * @return Whether the heuristic has been set.
+	 */
+	bool setHeuristic(Symbol* symbol, bool astar = false);
+
+	/**
+	 * Set the heuristic as an external function (before the search starts).
+	 *
+	 * @param heuristic Heuristic object (that must outlive the search).
+	 * @param astar Whether the depth is added to the heuristic value.
+	 *
+	 * @return Whether the heuristic has been set.
+	 */
+	bool setHeuristic(SearchHeuristic* heuristic, bool astar = false);
+
+	/**
+	 * Bound the number of states in the frontier (non-positive for no bound).
+	 */
+	void setBeamWidth(int width);
+
+	/**
+	 * Bound the number of stored states (non-positive for no bound).
+	 */
+	void setMaxStates(long long maxStates);
+
+	/**
+	 * Get the matching substitution of the current solution.
+	 */
+	EasySubstitution* getSubstitution() const;
+
+	/**
+	 * Get the number of the state of the current solution (or @c -1).
+	 */
+	int getStateNr() const;
+
+	/**
+	 * Get the number of stored states.
+	 */
+	int getNrStates() const;
+
+	/**
+	 * Get the parent of a state (@c -1 for the initial one).
+	 *
+	 * @param stateNr The number of a state in the search graph.
+	 */
+	int getStateParent(int stateNr) const;
+
+	/**
+	 * Get the depth of a state.
+	 *
+	 * @param stateNr The number of a state in the search graph.
+	 */
+	int getStateDepth(int stateNr) const;
+
+	/**
+	 * Get the priority of a state.
+	 *
+	 * @param stateNr The number of a state in the search graph.
+	 */
+	double getStatePriority(int stateNr) const;
+
+	/**
+	 * Get the number of states pending exploration.
+	 */
+	long long getFrontierSize() const;
+
+	/**
+	 * Get the number of states dropped by the beam width or the
+	 * bound on the number of stored states.
+	 */
+	long long getNrDropped() const;
+
+	/**
+	 * Save the state of the search to a file, including the stored
+	 * states with their parents, rules, depths and priorities, the
+	 * frontier, the current solution and the counters.
+	 *
+	 * @param path Path of the file (replaced atomically).
+	 *
+	 * @return Whether the checkpoint has been written.
+	 */
+	bool checkpoint(const std::string &path) const;
+
+	/**
+	 * Resume the search from a checkpoint (before it starts).
+	 *
+	 * The search must have been created with the same initial term,
+	 * pattern, condition, and options (heuristic, beam width and
+	 * bound on the stored states) as the saved one, possibly in another
+	 * process after loading the same modules.
+	 *
+	 * @param path Path of the file.
+	 *
+	 * @return Whether the search has been restored.
+	 */
+	bool restore(const std::string &path);
+
+	%extend {
+		~BestFirstSearch() {
+			forgetMonitor($self);
+			delete $self;
+		}
+
+		/**
+		 * Get the number of rewrites until this point of the search.
+		 */
+		int getRewriteCount() {
+			return $self->getContext()->getTotalCount();
+		}
+
+		/**
+		 * Get the rewrite counts until this point of the search.
+		 */
+		RewriteStats getStats() {
+			return StatsRecorder::fromContext($self->getContext());
+		}
+
+		/**
+		 * Get the rule leading to the given state.
+		 *
+		 * @param stateNr The number of a state in the search graph
+		 * or -1 for the current one.
+		 */
+		Rule* getRule(int stateNr = -1) {
+			return $self->getStateRule(stateNr == -1
+				? $self->getStateNr() : stateNr);
+		}
+
+		/**
+		 * Get the term of a given state.
+		 *
+		 * @param stateNr The number of a state in the search graph.
+		 */
+		EasyTerm* getStateTerm(int stateNr) {
+			return new EasyTerm($self->getStateDag(stateNr));
+		}
+
+		/**
+		 * Get the path from the initial state to the given one.
+		 *
+		 * @param stateNr The number of a state in the search graph
+		 * or -1 for the current one.
+		 *
+		 * @return The states of the path with the rules leading to them.
+		 */
+		std::vector<PathStep> getPath(int stateNr = -1) {
+			return getPath(*$self, stateNr);
+		}
+
+		/**
+		 * Get the state numbers of the path from the initial state
+		 * to the given one.
+		 *
+		 * @param stateNr The number of a state in the search graph
+		 * or -1 for the current one.
+		 */
+		std::vector<int> getPathStates(int stateNr = -1) {
+			return getPathStates(*$self, stateNr);
+		}
+
+		/**
+		 * Get the current progress of the search.
+		 */
+		SearchProgress getProgress() {
+			return getMonitor($self)->getProgress();
+		}
+
+		/**
+		 * Set a callback for the progress of the search, which is
+		 * checked at every rule rewrite while the search runs.
+		 *
+		 * @param callback Callback object (that must outlive the search)
+		 * or null to remove the current one.
+		 * @param everyStates Number of new states between calls
+		 * (non-positive to disable this criterion).
+		 * @param everyMillis Milliseconds between calls (non-positive
+		 * to disable this criterion).
+		 */
+		void setProgressCallback(ProgressCallback* callback, long long everyStates = 0,
+		                         double everyMillis = 1000) {
+			getMonitor($self)->setCallback(callback, everyStates, everyMillis);
+		}
+
+		/**
+		 * Get the next match.
+		 *
+		 * @return A term or a null pointer if there is no more matches.
+		 */
+		EasyTerm* __next() {
+			SearchMonitor::Scope scope(findMonitor($self));
+			return $self->next();
+		}
+
+		/**
+		 * Get the next matches.
+		 *
+		 * @param n Maximum number of matches.
+		 *
+		 * @return Up to @c n solutions (fewer if the end has been reached).
+		 */
+		std::vector<SearchSolution> next(int n) {
+			SearchMonitor::Scope scope(findMonitor($self));
+			std::vector<SearchSolution> solutions;
+
+			for (int i = 0; i < n; i++) {
+				EasyTerm* term = $self->next();
+
+				if (term == nullptr)
+					break;
+
+				solutions.push_back({term, $self->getSubstitution(), nullptr,
+				                     $self->getStateNr(),
+				                     $self->getContext()->getTotalCount()});
+			}
+
+			return solutions;
+		}
+	}
+};
+
 /**
  * An iterator through narrowing solutions.
  */
@@ -736,6 +1422,40 @@ public:
 			return new EasyTerm(stateDag);
 		}
 
+		/**
+		 * Get the next solutions of the narrowing search.
+		 *
+		 * @param n Maximum number of solutions.
+		 *
+		 * @return Up to @c n solutions (fewer if the end has been reached)
+		 * with their accumulated substitutions and variant unifiers.
+		 */
+		std::vector<SearchSolution> next(int n) {
+			std::vector<SearchSolution> solutions;
+
+			for (int i = 0; i < n && $self->findNextUnifier(); i++) {
+				DagNode *stateDag, *dummy;
+				int variableFamily;
+				Substitution* substitution;
+
+				$self->getStateInfo(stateDag, variableFamily, dummy, substitution);
+
+				const Vector<DagNode*>* unifier = $self->getUnifier();
+				size_t nrVariables = unifier->size();
+				Substitution subs(nrVariables);
+
+				for (size_t j = 0; j < nrVariables; j++)
+					subs.bind(j, (*unifier)[j]);
+
+				solutions.push_back({new EasyTerm(stateDag),
+				                     new EasySubstitution(substitution, &$self->getInitialVariableInfo()),
+				                     new EasySubstitution(&subs, &$self->getUnifierVariableInfo()),
+				                     -1, $self->getContext()->getTotalCount()});
+			}
+
+			return solutions;
+		}
+
 		/**
 		 * Get the accumulated substitution.
 		 */
@@ -837,6 +1557,35 @@ public:
 			return new std::pair<EasyTerm*, EasySubstitution*>(new EasyTerm(d),
 			          new EasySubstitution(&subs, &$self->getVariableInfo()));
 		}
+
+		/**
+		 * Get the next variants.
+		 *
+		 * @param n Maximum number of variants.
+		 *
+		 * @return Up to @c n variants (fewer if the end has been reached)
+		 * with their substitutions.
+		 */
+		std::vector<SearchSolution> next(int n) {
+			std::vector<SearchSolution> solutions;
+
+			for (int i = 0; i < n && $self->findNextVariant(); i++) {
+				int nrFreeVariables, variableFamily;
+				const Vector<DagNode*>& variant = $self->getCurrentVariant(nrFreeVariables, variableFamily);
+				int nrVariables = variant.size() - 1;
+
+				Substitution subs(nrVariables);
+
+				for (int j = 0; j < nrVariables; j++)
+					subs.bind(j, variant[j]);
+
+				solutions.push_back({new EasyTerm(variant[nrVariables]),
+				                     new EasySubstitution(&subs, &$self->getVariableInfo()),
+				                     nullptr, -1, -1});
+			}
+
+			return solutions;
+		}
 	};
 
 	%unprotectDestructor(VariantSearch);
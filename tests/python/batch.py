@@ -0,0 +1,27 @@
+#
+# Test for the batch reduce and rewrite operations
+#
+
+import os
+import maude
+
+maude.init(advise=False)
+maude.load(os.path.join(os.path.dirname(__file__), '..', 'example.maude'))
+
+nat = maude.getModule('NAT')
+example = maude.getModule('EXAMPLE')
+
+# Terms from different modules can be mixed in the same batch
+terms = [nat.parseTerm(f'{n} * {n} + 1') for n in range(5)]
+terms.append(example.parseTerm('f(a, b)'))
+
+print(maude.Term.reduceMany(terms))
+print([str(t) for t in terms])
+
+# Rewriting with a bound per term
+terms = [example.parseTerm(s) for s in ('a', 'b', 'g(a)', 'a a b')]
+
+print(example.rewriteMany(terms, 1))
+print([str(t) for t in terms])
+print(example.rewriteMany(terms))
+print([str(t) for t in terms])
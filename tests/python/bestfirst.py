@@ -0,0 +1,102 @@
+#
+# Test for the best-first search with heuristics
+#
+
+import maude
+
+maude.init(advise=False)
+
+maude.input('''mod COUNTER is
+	protecting NAT .
+
+	op dist : Nat -> Nat .
+	op wrong : Nat -> Bool .
+
+	var N : Nat .
+
+	rl [inc] : N => s N .
+	rl [dbl] : N => N * 2 .
+
+	eq dist(N) = sd(N, 100) .
+	eq wrong(N) = N > 10 .
+endm''')
+
+counter = maude.getModule('COUNTER')
+
+initial = counter.parseTerm('1')
+target = counter.parseTerm('100')
+natk = counter.findSort('Nat').kind()
+dist = counter.findSymbol('dist', [natk], natk)
+
+
+class Distance(maude.SearchHeuristic):
+	def evaluate(self, state):
+		return abs(int(state) - 100)
+
+
+# Greedy search with a Maude operator as heuristic
+search = initial.search(maude.ANY_STEPS, target, heuristic=dist)
+term, subs, path, rewrites = next(search)
+
+print(term, search.getNrStates(), [str(item) for item in path()])
+
+# A* search with a Python heuristic
+distance = Distance()
+search = initial.search(maude.ANY_STEPS, target, heuristic=distance, astar=True)
+term, subs, path, rewrites = next(search)
+
+print(term, search.getStateDepth(search.getStateNr()), search.getPathStates())
+
+# A bounded beam and memory
+search = maude.BestFirstSearch(initial, maude.ANY_STEPS, counter.parseTerm('N:Nat'),
+                               [maude.EqualityCondition(counter.parseTerm('N:Nat'), target)])
+search.setHeuristic(dist)
+search.setBeamWidth(4)
+search.setMaxStates(1000)
+
+for term, subs, path, rewrites in search:
+	print(term, subs, search.getFrontierSize() <= 4, search.getNrDropped() > 0)
+	break
+
+# A* search where the first path found to a state is not the shortest
+maude.input('''mod DETOUR is
+	sort Place .
+	ops start a a2 b x goal : -> Place [ctor] .
+
+	rl start => a .
+	rl start => b .
+	rl a => a2 .
+	rl a2 => x .
+	rl b => x .
+	rl x => goal .
+endm''')
+
+detour = maude.getModule('DETOUR')
+
+
+class Estimate(maude.SearchHeuristic):
+	# Admissible but inconsistent, so x is reached first through a and a2
+	values = {'b': 1.5}
+
+	def evaluate(self, state):
+		return self.values.get(str(state), 0)
+
+
+estimate = Estimate()
+search = detour.parseTerm('start').search(maude.ANY_STEPS, detour.parseTerm('goal'),
+                                          heuristic=estimate, astar=True)
+term, subs, path, rewrites = next(search)
+
+print(term, search.getStateDepth(search.getStateNr()), [str(item) for item in path()])
+
+# Heuristic values that are not numbers stop the search with a warning
+class Undefined(maude.SearchHeuristic):
+	def evaluate(self, state):
+		return float('nan')
+
+
+wrong = counter.findSymbol('wrong', [natk], counter.findSort('Bool').kind())
+undefined = Undefined()
+
+for heuristic in (wrong, undefined):
+	print(next(initial.search(maude.ANY_STEPS, target, heuristic=heuristic), None))
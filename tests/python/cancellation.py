@@ -0,0 +1,34 @@
+#
+# Test for the cancellation of Maude operations
+#
+
+import threading
+import maude
+
+maude.init(advise=False)
+maude.input('''fmod LOOP is
+	sort S .
+	ops loop done : -> S .
+	eq loop = loop .
+endfm''')
+
+m = maude.getModule('LOOP')
+
+# Timeout
+with maude.CancellationToken(0.2) as token:
+	m.parseTerm('loop').reduce()
+
+print(token.isCancelled(), token.hasExpired())
+
+# The token is not active anymore
+term = m.parseTerm('done')
+print(term.reduce(), term)
+
+# Cancellation from another thread
+token = maude.CancellationToken()
+threading.Timer(0.2, token.cancel).start()
+
+with token:
+	m.parseTerm('loop').reduce()
+
+print(token.isCancelled(), token.hasExpired())
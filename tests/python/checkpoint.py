@@ -0,0 +1,62 @@
+#
+# Test for the checkpoints of best-first searches
+#
+
+import os
+import tempfile
+import maude
+
+maude.init(advise=False)
+maude.load(os.path.join(os.path.dirname(__file__), '..', 'example.maude'))
+
+example = maude.getModule('EXAMPLE')
+
+initial = example.parseTerm('a a b c a')
+target = example.parseTerm('L:SymbolList c')
+
+# Solutions of the uninterrupted search
+expected = [str(term) for term, *_ in maude.BestFirstSearch(initial, maude.ANY_STEPS, target)]
+
+with tempfile.TemporaryDirectory() as directory:
+	path = os.path.join(directory, 'search.ckpt')
+
+	# The search is interrupted after some solutions
+	search = maude.BestFirstSearch(initial, maude.ANY_STEPS, target)
+	first = [str(term) for term, *_ in search.next(3)]
+
+	print(search.checkpoint(path), search.getNrStates(), search.getFrontierSize())
+	rewrites = search.getRewriteCount()
+	del search
+
+	# and resumed as a new search
+	search = maude.BestFirstSearch(initial, maude.ANY_STEPS, target)
+	print(search.restore(path), search.getNrStates(), search.getRewriteCount() == rewrites)
+
+	rest = [str(term) for term, *_ in search]
+	print('Same solutions:', first + rest == expected)
+
+	# Checkpoints of other searches are rejected
+	other = maude.BestFirstSearch(initial, maude.NORMAL_FORM, target)
+	print(other.restore(path))
+
+	other = maude.BestFirstSearch(example.parseTerm('a'), maude.ANY_STEPS, target)
+	print(other.restore(path))
+
+	print(search.restore(path), maude.BestFirstSearch(initial, maude.ANY_STEPS, target)
+	      .restore(os.path.join(directory, 'missing')))
+
+	# Term.search returns a checkpointable search when a path is given
+	search = initial.search(maude.ANY_STEPS, target, checkpoint=path)
+	print(type(search).__name__, search.getNrStates())
+
+	fresh = initial.search(maude.ANY_STEPS, target, checkpoint=os.path.join(directory, 'new.ckpt'))
+	print(type(fresh).__name__, [str(term) for term, *_ in fresh] == expected)
+
+	# Invalid checkpoints are not silently replaced by a new search
+	with open(os.path.join(directory, 'bad.ckpt'), 'wb') as bad:
+		bad.write(b'garbage')
+
+	try:
+		initial.search(maude.ANY_STEPS, target, checkpoint=os.path.join(directory, 'bad.ckpt'))
+	except ValueError as error:
+		print('Error:', error)
@@ -0,0 +1,35 @@
+#
+# Test for the flat export of terms
+#
+
+import os
+import maude
+
+maude.init(advise=False)
+maude.load(os.path.join(os.path.dirname(__file__), '..', 'example.maude'))
+maude.load('smt')
+
+example = maude.getModule('EXAMPLE')
+conversion = maude.getModule('CONVERSION')
+smt = maude.getModule('REAL-INTEGER')
+
+terms = [
+	example.parseTerm('f(g(a), g(a))'),
+	example.parseTerm('a b a ; c ; X:Symbol'),
+	conversion.parseTerm('s_^10(N:Nat) + 12345678901234567890'),
+	conversion.parseTerm('string(1.5e10) + "string" + qid("a")'),
+	smt.parseTerm('34/12 + X:Real'),
+]
+
+for term in terms:
+	term.reduce()
+	flat = term.flatten()
+	symbols = term.symbol().getModule().getSymbols()
+
+	print(term)
+
+	for symbol, arity, number, text in zip(flat.symbols, flat.arities, flat.numbers, flat.texts):
+		if symbol < 0:
+			print('  ->', -symbol - 1)
+		else:
+			print(' ', symbols[symbol], arity, number, flat.strings[text] if text >= 0 else '')
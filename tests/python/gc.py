@@ -0,0 +1,21 @@
+#
+# Test for the garbage collector statistics
+#
+
+import maude
+
+maude.init(advise=False)
+
+nat = maude.getModule('NAT')
+
+before = maude.getGcStats()
+print(before.roots)
+
+terms = [nat.parseTerm(f'{n} ^ 50 + {n} * 3') for n in range(2000)]
+maude.Term.reduceMany(terms)
+del terms
+
+maude.collectGarbage()
+after = maude.getGcStats()
+
+print(after.roots == before.roots, after.collections > before.collections, after.nodesInUse > 0, after.arenas > 0, after.forcedTime >= 0)
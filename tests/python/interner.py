@@ -0,0 +1,39 @@
+#
+# Test for the term interner and the term containers
+#
+
+import os
+import maude
+
+maude.init(advise=False)
+maude.load(os.path.join(os.path.dirname(__file__), '..', 'example.maude'))
+
+example = maude.getModule('EXAMPLE')
+interner = maude.TermInterner(example)
+
+terms = [example.parseTerm(text) for text in ('a b c', 'a ; b', 'b ; a', 'f(a, b)', '(a b) c', 'a b c')]
+handles = interner.internMany(terms)
+
+print(handles, interner.size())
+
+# Handles do not change when the original terms are modified
+first = terms[3]
+print(interner.find(first), first.rewrite(1), interner.find(first))
+print(interner.getTerm(handles[3]), interner.getHash(handles[3]) == interner.getTerm(handles[3]).hash())
+
+# Terms from other modules are rejected
+nat = maude.getModule('NAT')
+print(interner.intern(nat.parseTerm('0')), interner.getTerm(100))
+
+# Sets and maps of terms
+visited = maude.TermSet(example)
+
+print(visited.insertMany(terms), len(visited), visited.containsMany(terms))
+print(example.parseTerm('b ; a') in visited, example.parseTerm('c') in visited, list(visited))
+
+distances = maude.TermMap(example)
+distances.setMany(terms, list(range(len(terms))))
+distances[example.parseTerm('c')] = 10
+
+print(len(distances), distances[example.parseTerm('a ; b')], distances.get(example.parseTerm('a'), 42))
+print(dict((str(key), value) for key, value in distances.items()))
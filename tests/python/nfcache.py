@@ -0,0 +1,34 @@
+#
+# Test for the normal form cache of modules
+#
+
+import maude
+
+maude.init(advise=False)
+
+nat = maude.getModule('NAT')
+nat.setNormalFormCacheSize(2)
+
+for text in ('2 ^ 10', '2 ^ 10', '3 * 4', '2 ^ 10', '5 + 6', '3 * 4'):
+	term = nat.parseTerm(text)
+	rewrites = term.reduce()
+	print(text, '->', term, f'({rewrites} rewrites)')
+
+# Non-ground terms are not cached
+var = nat.parseTerm('N:Nat + 0')
+var.reduce()
+
+# Batch reductions also use the cache
+terms = [nat.parseTerm(text) for text in ('2 ^ 10', '7 * 8', '7 * 8')]
+print(maude.Term.reduceMany(terms), terms)
+
+stats = nat.getNormalFormCacheStats()
+print(f'hits={stats.hits} misses={stats.misses} evictions={stats.evictions} size={stats.size}/{stats.capacity}')
+
+# The repeated 2 ^ 10 must have been found in the cache
+print('Cache hits:', stats.hits > 0)
+assert stats.hits > 0
+
+nat.clearNormalFormCache()
+nat.setNormalFormCacheSize(0)
+print(nat.getNormalFormCacheStats().capacity)
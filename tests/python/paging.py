@@ -0,0 +1,33 @@
+#
+# Test for the paged retrieval of search solutions
+#
+
+import os
+import maude
+
+maude.init(advise=False)
+maude.load(os.path.join(os.path.dirname(__file__), '..', 'example.maude'))
+
+example = maude.getModule('EXAMPLE')
+
+initial = example.parseTerm('a a b c')
+target = example.parseTerm('L:SymbolList c')
+
+# Solutions of a search in pages of three
+search = initial.search(maude.ANY_STEPS, target)
+
+while solutions := search.next(3):
+	print('Page of', len(solutions))
+	for term, subs, _, stateNr, rewrites in solutions:
+		print(' ', term, subs, stateNr, rewrites)
+
+# The same solutions are obtained by the iterator
+print(len(list(initial.search(maude.ANY_STEPS, target))))
+
+# Matches
+matches = example.parseTerm('a b c').match(example.parseTerm('L:SymbolList X:Symbol'))
+print([str(subs) for _, subs, *_ in matches.next(10)])
+
+# Unifiers
+problem = example.unify([(example.parseTerm('f(X:Symbol, b)'), example.parseTerm('f(a, Y:Symbol)'))])
+print([str(subs) for _, subs, *_ in problem.next(100)])
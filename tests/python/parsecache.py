@@ -0,0 +1,28 @@
+#
+# Test for the parse cache of modules
+#
+
+import maude
+
+maude.init(advise=False)
+
+nat = maude.getModule('NAT')
+nat.setParseCacheSize(2)
+
+var = nat.parseTerm('N:Nat')
+
+for text in ('1 + 2', '1 + 2', 'N + 1', '1 + 2', 'N + 1', '3 * 4'):
+	term = nat.parseTerm(text, vars=[var])
+	term.reduce()
+	print(text, '->', term)
+
+stats = nat.getParseCacheStats()
+print(f'hits={stats.hits} misses={stats.misses} evictions={stats.evictions} size={stats.size}/{stats.capacity}')
+
+# Strategies are also cached
+strat = maude.getModule('NAT').parseStrategy('idle ; fail')
+print(strat, nat.getParseCacheStats().misses)
+
+nat.clearParseCache()
+nat.setParseCacheSize(0)
+print(nat.getParseCacheStats().capacity)
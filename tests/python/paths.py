@@ -0,0 +1,58 @@
+#
+# Test for the extraction of whole paths in searches and graphs
+#
+
+import os
+import maude
+
+maude.init(advise=False)
+maude.load(os.path.join(os.path.dirname(__file__), '..', 'example.maude'))
+
+example = maude.getModule('EXAMPLE')
+
+initial = example.parseTerm('a a b')
+target = example.parseTerm('c c c')
+
+# Path to the solution of a search
+search = initial.search(maude.ANY_STEPS, target)
+term, subs, path, rewrites = next(search)
+
+print([str(item) for item in path()])
+print(search.getPathStates())
+print([(step, str(term)) for step, term in zip(search.getPathStates(), search.getPath()[::2])])
+
+# The same in a strategy-controlled search
+search = initial.search(maude.ANY_STEPS, target, strategy=example.parseStrategy('(ab | bc | ac) *'))
+term, subs, path, strategy, rewrites = next(search)
+
+print([str(item) for item in path()])
+print(search.getPathStates())
+
+# Paths in rewrite graphs
+graph = maude.RewriteGraph(example.parseTerm('a b'))
+
+# Explore the whole graph
+stateNr = 0
+while stateNr < graph.getNrStates():
+	index = 0
+	while graph.getNextState(stateNr, index) >= 0:
+		index += 1
+	stateNr += 1
+
+for stateNr in range(graph.getNrStates()):
+	print(stateNr, graph.getPathStates(stateNr), [str(item) for item in graph.getPath(stateNr)])
+
+graph = maude.StrategyRewriteGraph(example.parseTerm('a b'), example.parseStrategy('ab ; bc ; bc'))
+
+stateNr = 0
+while stateNr < graph.getNrStates():
+	index = 0
+	while graph.getNextState(stateNr, index) >= 0:
+		index += 1
+	stateNr += 1
+
+for stateNr in range(graph.getNrStates()):
+	print(stateNr, graph.getPathStates(stateNr), [str(item) for item in graph.getPath(stateNr)])
+
+# Invalid states yield empty paths
+print(graph.getPath(1000), graph.getPathStates(-5))
@@ -0,0 +1,34 @@
+#
+# Test for the pool of worker processes
+#
+
+import os
+import maude
+
+maude.init(advise=False)
+maude.load(os.path.join(os.path.dirname(__file__), '..', 'example.maude'))
+
+nat = maude.getModule('NAT')
+example = maude.getModule('EXAMPLE')
+
+pool = maude.EnginePool(2)
+print('Workers:', pool.getNrWorkers())
+
+# Reductions (the original terms are not modified)
+terms = [nat.parseTerm(f'{n} ^ {n}') for n in range(10)]
+
+for term, (result, rewrites) in zip(terms, pool.reduce(terms)):
+	print(term, '->', result, f'({rewrites} rewrites)')
+
+# Rewriting
+for result, rewrites in pool.rewrite([example.parseTerm('a a b'), example.parseTerm('f(a, b)')]):
+	print(result, rewrites)
+
+# Searches from multiple initial terms
+target = example.parseTerm('X:Symbol')
+initial = [example.parseTerm(s) for s in ('a', 'b', 'c')]
+
+for term, solutions in zip(initial, pool.search(initial, maude.ANY_STEPS, target)):
+	print(term, '=>*', ', '.join(map(str, solutions)))
+
+pool.shutdown()
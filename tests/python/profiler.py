@@ -0,0 +1,41 @@
+#
+# Test for the statement profiler
+#
+
+import maude
+
+maude.init(advise=False)
+maude.input('''fmod PROFILED is
+	protecting NAT .
+
+	op fib : Nat -> Nat .
+	op even : Nat -> Bool .
+
+	var N : Nat .
+
+	eq fib(0) = 0 .
+	eq fib(1) = 1 .
+	ceq fib(s s N) = fib(N) + fib(s N) if N < 100 .
+
+	eq even(N) = true [owise] .
+	ceq even(N) = false if N rem 2 == 1 .
+endfm''')
+
+mod = maude.getModule('PROFILED')
+maude.setProfiling(True, False)
+
+for text in ('fib(10)', 'even(3)', 'even(4)'):
+	term = mod.parseTerm(text)
+	term.reduce()
+	print(term)
+
+for eq in mod.getEquations():
+	stats = mod.getProfile(eq)
+	print(eq, stats.rewrites, stats.conditionStarts,
+	      list(stats.fragmentSuccesses), list(stats.fragmentFailures))
+
+print(len(mod.showProfile()) > 0)
+
+mod.clearProfile()
+maude.setProfiling(False)
+print(mod.getProfile(mod.getEquations()[0]).rewrites)
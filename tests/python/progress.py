@@ -0,0 +1,58 @@
+#
+# Test for the progress counters and callbacks of searches
+#
+
+import os
+import maude
+
+maude.init(advise=False)
+maude.load(os.path.join(os.path.dirname(__file__), '..', 'example.maude'))
+
+example = maude.getModule('EXAMPLE')
+
+
+class Printer(maude.ProgressCallback):
+	def __init__(self):
+		super().__init__()
+		self.calls = 0
+
+	def report(self, progress):
+		self.calls += 1
+		print(' ', progress.nrStates, progress.frontierSize, progress.depth)
+
+
+initial = example.parseTerm('a a a b b')
+target = example.parseTerm('c c c c c')
+
+# Callback every two states
+search = initial.search(maude.ANY_STEPS, target)
+printer = Printer()
+search.setProgressCallback(printer, everyStates=2, everyMillis=0)
+
+print(len(list(search)), printer.calls > 0)
+
+progress = search.getProgress()
+print(progress.nrStates, progress.nrDuplicates, progress.depth, progress.rewrites, progress.storageBytes)
+
+# Rewrite graphs
+graph = maude.RewriteGraph(example.parseTerm('a b'))
+graph.setProgressCallback(printer, everyStates=1, everyMillis=0)
+
+stateNr = 0
+while stateNr < graph.getNrStates():
+	index = 0
+	while graph.getNextState(stateNr, index) >= 0:
+		index += 1
+	stateNr += 1
+
+print(graph.getProgress().nrStates)
+
+# Parallel search (whose callback is called after every level)
+pool = maude.EnginePool(0)
+search = maude.ParallelSearch(pool, initial, maude.ANY_STEPS, target)
+search.setProgressCallback(printer, everyStates=1, everyMillis=0)
+
+print(len(list(search)))
+
+progress = search.getProgress()
+print(progress.nrStates, progress.nrDuplicates, progress.frontierSize, progress.depth)
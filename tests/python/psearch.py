@@ -0,0 +1,79 @@
+#
+# Test for the parallel breadth-first search
+#
+
+import os
+import maude
+
+maude.init(advise=False)
+maude.load(os.path.join(os.path.dirname(__file__), '..', 'example.maude'))
+
+example = maude.getModule('EXAMPLE')
+
+pool = maude.EnginePool(2)
+
+initial = example.parseTerm('a a b c')
+target = example.parseTerm('L:SymbolList c')
+
+# Solutions are obtained level by level
+search = maude.ParallelSearch(pool, initial, maude.ANY_STEPS, target)
+
+for solution in search:
+	print(search.getDepth(), solution)
+
+print('States:', search.getNrStates(), 'Rewrites:', search.getRewriteCount(),
+      'Partitions:', search.getNrPartitions())
+
+# The sequential search finds the same solutions
+sequential = {str(sol) for sol, *_ in initial.search(maude.ANY_STEPS, target)}
+parallel = {str(sol) for sol in maude.ParallelSearch(pool, initial, maude.ANY_STEPS, target)}
+print('Same solutions:', sequential == parallel)
+
+# Normal forms and depth bounds
+for solution in maude.ParallelSearch(pool, initial, maude.NORMAL_FORM, target):
+	print('=>!', solution)
+
+for solution in maude.ParallelSearch(pool, initial, maude.ONE_STEP, target):
+	print('=>1', solution)
+
+print(len(list(maude.ParallelSearch(pool, initial, maude.ANY_STEPS, target, 2))))
+
+# Compacted storage of the visited states
+for storage in (maude.HASH_COMPACTION, maude.BITSTATE_HASHING):
+	search = maude.ParallelSearch(pool, initial, maude.ANY_STEPS, target)
+	search.setStateStorage(storage, 16)
+	print(len(list(search)), search.getNrStates(), search.getOmissionProbability())
+
+# Visited states on disk with a small cache in memory
+search = maude.ParallelSearch(pool, initial, maude.ANY_STEPS, target)
+search.setStateStorage(maude.DISK_STATES, 2)
+print(len(list(search)), search.getNrStates())
+
+# Without workers, the search runs in the current process
+local = maude.EnginePool(0)
+print(len(list(maude.ParallelSearch(local, initial, maude.ANY_STEPS, target))))
+
+# Rules and patterns that depend on subsorts and memberships (two rules
+# produce the same successors, which are sent only once)
+maude.input('''mod COUNTER is
+	protecting NAT .
+	sorts Small Counter .
+	subsort Small < Counter .
+	op c : Nat -> Counter [ctor] .
+	var N : Nat .
+	cmb c(N) : Small if N < 4 .
+	crl [inc] : c(N) => c(s N) if c(N) :: Small .
+	crl [again] : c(N) => c(s N) if c(N) :: Small .
+endm''')
+
+counter = maude.getModule('COUNTER')
+initial = counter.parseTerm('c(0)')
+
+for pattern in ('S:Small', 'C:Counter'):
+	target = counter.parseTerm(pattern)
+	sequential = {str(sol) for sol, *_ in initial.search(maude.ANY_STEPS, target)}
+	search = maude.ParallelSearch(pool, initial, maude.ANY_STEPS, target)
+	parallel = {str(sol) for sol in search}
+	print(len(parallel), search.getNrStates(), sequential == parallel)
+
+pool.shutdown()
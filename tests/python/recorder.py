@@ -0,0 +1,39 @@
+#
+# Test for the recorder of rewrite steps
+#
+
+import os
+import maude
+
+maude.init(advise=False)
+maude.load(os.path.join(os.path.dirname(__file__), '..', 'example.maude'))
+
+example = maude.getModule('EXAMPLE')
+
+# Only rule steps
+with maude.TraceRecorder(16, False) as recorder:
+	term = example.parseTerm('a a ; b')
+	term.rewrite()
+
+for k in range(len(recorder)):
+	print(recorder.getRule(k).getLabel(), recorder.getRedex(k), '=>', recorder.getResult(k))
+
+# Equational steps in a small buffer
+recorder = maude.TraceRecorder(4)
+
+with recorder:
+	maude.getModule('NAT').parseTerm('2 ^ 10 + 3 * 4 + 5').reduce()
+
+print(recorder.getTotalSteps(), len(recorder))
+
+for k in range(len(recorder)):
+	print(recorder.getKind(k), recorder.getRedex(k), '->', recorder.getResult(k))
+
+# Lazy iterators are recorded while the recorder is active
+search = example.parseTerm('a ; b').search(maude.ANY_STEPS, example.parseTerm('c ; c'))
+recorder.clear()
+
+with recorder:
+	next(search)
+
+print(recorder.getTotalSteps(), recorder.getKind(100))
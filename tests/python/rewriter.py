@@ -0,0 +1,25 @@
+#
+# Test for the resumable rewriting sessions
+#
+
+import os
+import maude
+
+maude.init(advise=False)
+maude.load(os.path.join(os.path.dirname(__file__), '..', 'example.maude'))
+
+example = maude.getModule('EXAMPLE')
+term = example.parseTerm('a a a ; b b ; f(a, b)')
+
+for mode in (maude.Rewriter.REWRITE, maude.Rewriter.FREWRITE):
+	rewriter = maude.Rewriter(term, mode)
+
+	while not rewriter.isFinished():
+		state, rewrites = rewriter.step(2)
+		print(state, rewrites)
+
+	print(rewriter.getRewriteCount(), rewriter.getState(), term)
+
+# Compare with a single rewrite
+whole = term.copy()
+print(whole.frewrite(), whole)
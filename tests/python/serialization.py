@@ -0,0 +1,48 @@
+#
+# Test for the serialization of terms
+#
+
+import os
+import pickle
+import maude
+
+maude.init(advise=False)
+maude.load(os.path.join(os.path.dirname(__file__), '..', 'example.maude'))
+maude.load('smt')
+
+example = maude.getModule('EXAMPLE')
+conversion = maude.getModule('CONVERSION')
+smt = maude.getModule('REAL-INTEGER')
+
+terms = [
+	example.parseTerm('f(g(a), g(a))'),
+	example.parseTerm('a b a ; c ; X:Symbol'),
+	conversion.parseTerm('s_^10(N:Nat) + 12345678901234567890'),
+	conversion.parseTerm('string(1.5e10) + "string" + qid("a")'),
+	conversion.parseTerm('float(1/3)'),
+	smt.parseTerm('34/12 + X:Real'),
+]
+
+for term in terms:
+	for reduced in (False, True):
+		if reduced:
+			term.reduce()
+
+		data = term.serialize()
+		copy = maude.Term.deserialize(term.symbol().getModule(), data)
+		print(term, len(data), copy, copy == term)
+
+# Pickling (the module is located by name)
+for term in terms:
+	copy = pickle.loads(pickle.dumps(term))
+	print(copy, copy.symbol().getModule(), copy == term)
+
+# Reduced copies keep their sorts, so they match patterns with
+# sort-constrained variables and can be rewritten
+for text, pattern in (('a b c', 'X:Symbol L:SymbolList'), ('c ; a ; b', 'X:Symbol ; S:SymbolSet')):
+	term = example.parseTerm(text)
+	term.reduce()
+
+	copy = maude.Term.deserialize(example, term.serialize())
+	print(copy, copy.getSort(), len(list(copy.match(example.parseTerm(pattern)))))
+	print(copy.rewrite(), copy)
@@ -0,0 +1,69 @@
+#
+# Test for the Monte Carlo simulation of random walks
+#
+
+import maude
+
+maude.init(advise=False)
+
+maude.input('''mod WALK is
+	protecting INT .
+
+	sort State .
+	op <_> : Int -> State [ctor] .
+	op pos : State -> Int .
+
+	var N : Int .
+
+	rl [up] : < N > => < N + 1 > .
+	rl [down] : < N > => < N - 1 > .
+	crl [stop] : < N > => < N > if N > 10 .
+
+	eq pos(< N >) = N .
+endm''')
+
+walk = maude.getModule('WALK')
+
+initial = walk.parseTerm('< 0 >')
+statek = walk.findSort('State').kind()
+pos = walk.findSymbol('pos', [statek], walk.findSort('Int').kind())
+rules = {rule.getLabel(): rule for rule in walk.getRules()}
+
+pool = maude.EnginePool(2)
+
+# Unbiased walk observed every ten steps
+simulation = maude.Simulation(pool, initial, 50)
+simulation.addObservable(pos)
+simulation.setObservationSteps([0, 10, 20, 30, 40, 50])
+simulation.setRuleWeight(rules['stop'], 0)
+
+print(simulation.run(200, 7), simulation.getNrRuns(), simulation.getObservationSteps())
+print(simulation.getMeans(0), simulation.getVariances(0))
+print(len(simulation.getObservations(0)), set(simulation.getRunLengths()))
+
+# Results do not depend on the number of workers
+local = maude.Simulation(maude.EnginePool(0), initial, 50)
+local.addObservable(pos)
+local.setObservationSteps([0, 10, 20, 30, 40, 50])
+local.setRuleWeight(rules['stop'], 0)
+local.run(200, 7)
+
+print('Same results:', local.getObservations(0) == simulation.getObservations(0))
+
+# Biased walk (the mean drifts upwards)
+simulation.setRuleWeight(rules['up'], 3)
+simulation.run(200, 7)
+print(simulation.getMeans(0)[-1] > 0, simulation.getRewriteCount() > 0)
+
+# Disabling all rules leaves the runs at the initial state
+for rule in rules.values():
+	simulation.setRuleWeight(rule, 0)
+
+simulation.run(10)
+print(set(simulation.getRunLengths()), simulation.getMeans(0))
+
+# Invalid arguments are rejected with a warning
+print(simulation.getMeans(1), simulation.getVariances(-1), simulation.getObservations(5))
+print(simulation.run(-1), simulation.getNrRuns())
+
+pool.shutdown()
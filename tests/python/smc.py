@@ -0,0 +1,58 @@
+#
+# Test for the statistical model checking of LTL formulae
+#
+
+import maude
+
+maude.init(advise=False)
+maude.load('model-checker')
+
+maude.input('''mod WALK-CHECK is
+	protecting INT .
+	including MODEL-CHECKER .
+
+	op <_> : Int -> State [ctor] .
+	ops high low : -> Prop [ctor] .
+
+	var N : Int .
+
+	rl [up] : < N > => < N + 1 > .
+	rl [down] : < N > => < N - 1 > .
+
+	eq < N > |= high = N >= 3 .
+	eq < N > |= low = N <= -3 .
+endm''')
+
+walk = maude.getModule('WALK-CHECK')
+
+initial = walk.parseTerm('< 0 >')
+rules = {rule.getLabel(): rule for rule in walk.getRules()}
+
+pool = maude.EnginePool(2)
+
+# Probability of reaching a high position within ten steps
+checker = maude.StatisticalChecker(pool, initial, walk.parseTerm('<> high'), 10)
+print(checker.isValid())
+
+probability = checker.estimate(0.05, 0.05, 1)
+print(round(probability, 2), checker.getNrSamples(), checker.getNrSatisfied())
+
+# The estimation does not depend on the number of workers
+local = maude.StatisticalChecker(maude.EnginePool(0), initial, walk.parseTerm('<> high'), 10)
+print('Same estimation:', local.estimate(0.05, 0.05, 1) == probability)
+
+# Sequential tests with thresholds on each side of the probability
+print(checker.test(0.1) == maude.ABOVE_THRESHOLD, checker.getNrSamples())
+print(checker.test(0.9) == maude.BELOW_THRESHOLD, checker.getNrSamples())
+print(checker.test(probability, 0.001, maxSamples=100) == maude.TEST_UNDECIDED)
+
+# Rule weights bias the executions
+checker.setRuleWeight(rules['down'], 0)
+print(checker.estimate(0.05, 0.05), checker.getRewriteCount() > 0)
+
+# Formulae with until and next
+for formula in ('~ low U high', '[] ~ (high /\\ low)', 'O O O O high'):
+	checker = maude.StatisticalChecker(pool, initial, walk.parseTerm(formula), 10)
+	print(formula, round(checker.estimate(0.05, 0.05), 2))
+
+pool.shutdown()
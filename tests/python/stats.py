@@ -0,0 +1,31 @@
+#
+# Test for the statistics of rewriting operations
+#
+
+import os
+import maude
+
+maude.init(advise=False)
+maude.load(os.path.join(os.path.dirname(__file__), '..', 'example.maude'))
+
+example = maude.getModule('EXAMPLE')
+
+def show(stats):
+	print(f'total={stats.total} eq={stats.equational} rl={stats.rule} mb={stats.membership} '
+	      f'gc={stats.gcRuns} cpu={stats.cpuTime >= 0} real={stats.realTime >= 0}')
+
+show(maude.getModule('NAT').parseTerm('2 ^ 100 + 3 * 4').reduceWithStats())
+show(example.parseTerm('a a ; b').rewriteWithStats(10))
+show(example.parseTerm('a a ; b').frewriteWithStats(10))
+
+# Search iterators and rewriters report counts only
+search = example.parseTerm('a a ; b').search(maude.ANY_STEPS, example.parseTerm('L:SymbolSet'))
+
+for sol, subs, path, nrew in search:
+	pass
+
+show(search.getStats())
+
+rewriter = maude.Rewriter(example.parseTerm('a a ; b'))
+rewriter.step()
+show(rewriter.getStats())